@@ -0,0 +1,222 @@
+#include "concurrent_screen.h"
+#include <algorithm> //  std::min, std::sort
+#include <cmath>     //  std::floor, std::isnan
+
+class ConcurrentScreen::TileRangeLock {
+public:
+    TileRangeLock(const ConcurrentScreen& screen, std::size_t c0, std::size_t r0, std::size_t c1, std::size_t r1)
+        : m_screen(screen), m_c0(c0), m_r0(r0), m_c1(c1), m_r1(r1)
+    {
+        //     :         
+        forEach([](Tile& tile) { tile.mutex.lock(); });
+    }
+    ~TileRangeLock() {
+        forEach([](Tile& tile) { tile.mutex.unlock(); });
+    }
+
+    TileRangeLock(const TileRangeLock&) = delete;
+    TileRangeLock& operator=(const TileRangeLock&) = delete;
+
+    template <typename Func>
+    void forEach(Func func) const {
+        for (std::size_t r = m_r0; r <= m_r1; ++r) {
+            for (std::size_t c = m_c0; c <= m_c1; ++c) {
+                func(*m_screen.m_tiles[r * m_screen.m_tilesPerSide + c]);
+            }
+        }
+    }
+
+private:
+    const ConcurrentScreen& m_screen;
+    std::size_t m_c0;
+    std::size_t m_r0;
+    std::size_t m_c1;
+    std::size_t m_r1;
+};
+
+namespace {
+    //      (   SpatialGrid: floor    )
+    std::size_t tileIndex(double value, double tileSize, std::size_t count) noexcept {
+        double tile = std::floor(value / tileSize);
+        if (!(tile > 0)) {
+            return 0;
+        }
+        if (tile >= static_cast<double>(count)) {
+            return count - 1;
+        }
+        return static_cast<std::size_t>(tile);
+    }
+
+    void tileAxisRange(double v0, double v1, double tileSize, std::size_t count,
+        std::size_t& lo, std::size_t& hi) noexcept
+    {
+        // NaN       -     
+        if (std::isnan(v0) || std::isnan(v1)) {
+            lo = 0;
+            hi = count - 1;
+            return;
+        }
+        lo = tileIndex(v0, tileSize, count);
+        hi = tileIndex(v1, tileSize, count);
+    }
+}
+
+ConcurrentScreen::ConcurrentScreen(double width, double height, std::size_t tilesPerSide)
+    : m_width(width > 0 ? width : 100.0),
+    m_height(height > 0 ? height : 100.0),
+    m_tilesPerSide(std::max<std::size_t>(1, tilesPerSide)),
+    m_tileWidth(m_width / static_cast<double>(m_tilesPerSide)),
+    m_tileHeight(m_height / static_cast<double>(m_tilesPerSide)),
+    m_nextId(0),
+    m_count(0)
+{
+    m_tiles.reserve(m_tilesPerSide * m_tilesPerSide);
+    for (std::size_t r = 0; r < m_tilesPerSide; ++r) {
+        for (std::size_t c = 0; c < m_tilesPerSide; ++c) {
+            m_tiles.push_back(std::make_unique<Tile>(static_cast<double>(c) * m_tileWidth,
+                static_cast<double>(r) * m_tileHeight, m_tileWidth, m_tileHeight));
+        }
+    }
+}
+
+bool ConcurrentScreen::isInsideScreen(double x, double y, double w, double h) const noexcept {
+    return !(x < 0 || y < 0 || x + w > m_width || y + h > m_height);
+}
+
+void ConcurrentScreen::tileRange(double x, double y, double w, double h,
+    std::size_t& c0, std::size_t& r0, std::size_t& c1, std::size_t& r1) const noexcept
+{
+    //     -   x + w  y + h,     
+    tileAxisRange(x, x + w, m_tileWidth, m_tilesPerSide, c0, c1);
+    tileAxisRange(y, y + h, m_tileHeight, m_tilesPerSide, r0, r1);
+}
+
+PlacementResult ConcurrentScreen::insertRectangle(double x, double y, double w, double h,
+    Color color, bool notOverlap) noexcept
+{
+    // ,     , -  
+    if (const char* error = Rectangle::dimensionsError(w, h)) {
+        return PlacementResult::failure(error == kNonPositiveSizeError ?
+            PlacementError::NonPositiveSize : PlacementError::SizeTooLarge);
+    }
+    if (!Rectangle::isValidColor(color)) {
+        return PlacementResult::failure(PlacementError::InvalidColor);
+    }
+    if (!isInsideScreen(x, y, w, h)) {
+        return PlacementResult::failure(PlacementError::OutOfBounds);
+    }
+
+    std::size_t c0, r0, c1, r1;
+    tileRange(x, y, w, h, c0, r0, c1, r1);
+    TileRangeLock lock(*this, c0, r0, c1, r1);
+
+    //         .
+    //         ,   , 
+    //   -      .
+    if (notOverlap) {
+        std::size_t conflict = PlacementResult::npos;
+        lock.forEach([&](Tile& tile) {
+            std::size_t local = tile.grid.findOverlap(x, y, w, h);
+            if (local != SpatialGrid::kNoId) {
+                conflict = std::min(conflict, tile.ids[local]);
+            }
+        });
+        if (conflict != PlacementResult::npos) {
+            return PlacementResult::failure(PlacementError::Overlap, conflict);
+        }
+    }
+
+    //    :         
+    std::size_t id = m_nextId.fetch_add(1, std::memory_order_relaxed);
+    Tile& home = *m_tiles[r0 * m_tilesPerSide + c0];
+    bool stored = false;
+    std::size_t placed = 0;
+    try {
+        home.owned.push_back(x, y, w, h, color, notOverlap);
+        try {
+            home.ownedIds.push_back(id);
+        }
+        catch (...) {
+            home.owned.truncate(home.owned.size() - 1);
+            throw;
+        }
+        stored = true;
+        lock.forEach([&](Tile& tile) {
+            tile.ids.push_back(id);
+            try {
+                tile.grid.insert(tile.ids.size() - 1, x, y, w, h);
+            }
+            catch (...) {
+                tile.ids.pop_back();
+                throw;
+            }
+            ++placed;
+        });
+    }
+    catch (...) {
+        //  :   ,    
+        lock.forEach([&](Tile& tile) {
+            if (placed > 0) {
+                tile.grid.truncate(tile.ids.size() - 1);
+                tile.ids.pop_back();
+                --placed;
+            }
+        });
+        if (stored) {
+            home.owned.truncate(home.owned.size() - 1);
+            home.ownedIds.pop_back();
+        }
+        return PlacementResult::failure(PlacementError::OutOfMemory);
+    }
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    return PlacementResult::success(id);
+}
+
+PlacementResult ConcurrentScreen::insertRectangle(const Rectangle& rect) noexcept {
+    return insertRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(),
+        rect.getColorId(), rect.getNotOverlap());
+}
+
+void ConcurrentScreen::addRectangle(const Rectangle& rect) {
+    PlacementResult result = insertRectangle(rect);
+    if (result.error() == PlacementError::OutOfMemory) {
+        throw std::bad_alloc();
+    }
+    if (!result) {
+        throw ScreenError(placementErrorMessage(result.error()), rect);
+    }
+}
+
+std::vector<Rectangle> ConcurrentScreen::rectangles() const {
+    TileRangeLock lock(*this, 0, 0, m_tilesPerSide - 1, m_tilesPerSide - 1);
+
+    // (, ,   ),    
+    struct Ref {
+        std::size_t id;
+        const Tile* tile;
+        std::size_t index;
+    };
+    std::vector<Ref> refs;
+    refs.reserve(m_count.load(std::memory_order_relaxed));
+    lock.forEach([&](const Tile& tile) {
+        for (std::size_t i = 0; i < tile.ownedIds.size(); ++i) {
+            refs.push_back(Ref{ tile.ownedIds[i], &tile, i });
+        }
+    });
+    std::sort(refs.begin(), refs.end(), [](const Ref& a, const Ref& b) { return a.id < b.id; });
+
+    std::vector<Rectangle> result;
+    result.reserve(refs.size());
+    for (const Ref& ref : refs) {
+        result.push_back(ref.tile->owned[ref.index]);
+    }
+    return result;
+}
+
+Screen ConcurrentScreen::toScreen() const {
+    Screen screen(m_width, m_height);
+    //       notOverlap    ,
+    //    ,      Screen
+    screen.addRectangles(rectangles());
+    return screen;
+}
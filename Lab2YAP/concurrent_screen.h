@@ -0,0 +1,75 @@
+#pragma once
+
+#include "screen.h"
+#include "spatial_grid.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//       .
+//    tilesPerSide x tilesPerSide ,       .
+//     ,  ,    
+//   (   -   ).  notOverlap 
+//        ,      
+// :       .
+// ,     ,    .
+//      (PlacementResult),    .
+class ConcurrentScreen {
+public:
+    //    ,   Screen
+    ConcurrentScreen(double width, double height, std::size_t tilesPerSide = 16);
+
+    ConcurrentScreen(const ConcurrentScreen&) = delete;
+    ConcurrentScreen& operator=(const ConcurrentScreen&) = delete;
+
+    //      ,   Screen::insertRectangle.
+    // value() -  :       
+    // ( OutOfMemory   )
+    PlacementResult insertRectangle(double x, double y, double w, double h,
+        Color color = Color::None, bool notOverlap = false) noexcept;
+    PlacementResult insertRectangle(const Rectangle& rect) noexcept;
+    //    ScreenError   (std::bad_alloc -   )
+    void addRectangle(const Rectangle& rect);
+
+    double getWidth() const noexcept { return m_width; }
+    double getHeight() const noexcept { return m_height; }
+    //    (   - )
+    std::size_t size() const noexcept { return m_count.load(std::memory_order_relaxed); }
+
+    //        (  
+    //   ).      Screen.
+    std::vector<Rectangle> rectangles() const;
+    //       (,  saveSVG  saveBinary)
+    Screen toScreen() const;
+
+private:
+    //  
+    struct Tile {
+        Tile(double x, double y, double width, double height) : grid(x, y, width, height) {}
+
+        mutable std::mutex mutex;
+        SpatialGrid grid;                   //    -  (0, 1, 2...)
+        std::vector<std::size_t> ids;       //   ->  
+        // ,       (    )
+        std::vector<std::size_t> ownedIds;
+        RectangleStore owned;
+    };
+
+    //       
+    class TileRangeLock;
+
+    double m_width;
+    double m_height;
+    std::size_t m_tilesPerSide;
+    double m_tileWidth;
+    double m_tileHeight;
+    std::vector<std::unique_ptr<Tile>> m_tiles; // Tile    
+    std::atomic<std::size_t> m_nextId;
+    std::atomic<std::size_t> m_count;
+
+    bool isInsideScreen(double x, double y, double w, double h) const noexcept;
+    //   [c0, c1] x [r0, r1],   
+    void tileRange(double x, double y, double w, double h,
+        std::size_t& c0, std::size_t& r0, std::size_t& c1, std::size_t& r1) const noexcept;
+};
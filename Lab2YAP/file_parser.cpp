@@ -0,0 +1,368 @@
+#include "file_parser.h"
+#include "screen.h"  //  FileParseError
+#include "thread_pool.h"
+#include <charconv>  //  std::from_chars
+#include <cmath>     //  std::isfinite
+#include <cstring>   //  std::memchr
+#include <algorithm> //  std::count, std::max
+#include <exception> //  std::exception_ptr
+#include <thread>
+#include <memory>    //  std::unique_ptr
+#include <memory_resource>
+#include <cerrno>    //  errno  EINTR
+
+#ifdef _WIN32
+#include <io.h>      //  _read
+#else
+#include <unistd.h>  //  read
+#endif
+
+namespace {
+    //  ,    operator>> ( '\r'   Windows)
+    bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    //    ;  ,    
+    std::string_view nextToken(const char*& pos, const char* end) noexcept {
+        while (pos != end && isSpace(*pos)) {
+            ++pos;
+        }
+        const char* start = pos;
+        while (pos != end && !isSpace(*pos)) {
+            ++pos;
+        }
+        return std::string_view(start, static_cast<size_t>(pos - start));
+    }
+
+    //       (  ,   '+')
+    //  notOverlap   - "0"  "1"
+    bool isFlag(std::string_view token) noexcept {
+        return token == "0" || token == "1";
+    }
+
+    bool parseNumber(std::string_view token, double& value) noexcept {
+        const char* first = token.data();
+        const char* last = token.data() + token.size();
+        if (first != last && *first == '+') {
+            ++first;
+            if (first != last && *first == '-') {
+                return false; // "+-5" operator>>   
+            }
+        }
+        if (first == last) {
+            return false;
+        }
+        std::from_chars_result result = std::from_chars(first, last, value);
+        return result.ec == std::errc() && result.ptr == last && std::isfinite(value);
+    }
+}
+
+RectangleFileParser::RectangleFileParser(const std::string& filename, RectangleStore& out, int firstLine)
+    : m_filename(filename), m_out(out), m_lastColor(Color::None), m_lineNumber(firstLine),
+    m_leadingInherited(0), m_seenColor(false) {}
+
+const char* RectangleFileParser::parseLines(const char* begin, const char* end) {
+    const char* lineStart = begin;
+    while (lineStart != end) {
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(lineStart, '\n', static_cast<size_t>(end - lineStart)));
+        if (lineEnd == nullptr) {
+            break; //    
+        }
+        parseLine(lineStart, lineEnd);
+        lineStart = lineEnd + 1;
+    }
+    return lineStart;
+}
+
+void RectangleFileParser::parseLastLine(const char* begin, const char* end) {
+    if (begin != end) {
+        parseLine(begin, end);
+    }
+}
+
+void RectangleFileParser::parseLine(const char* begin, const char* end) {
+    m_lineNumber++;
+    const char* pos = begin;
+
+    //   4  
+    double values[4];
+    for (double& value : values) {
+        if (!parseNumber(nextToken(pos, end), value)) {
+            throw FileParseError(m_filename, m_lineNumber, "Invalid format - expected 'cx cy w h [color] [notOverlap]'");
+        }
+    }
+    double cx = values[0];
+    double cy = values[1];
+    double w = values[2];
+    double h = values[3];
+
+    //     notOverlap.    , 
+    // "0"/"1"    -  ,    
+    std::string_view color = nextToken(pos, end);
+    std::string_view flag;
+    if (isFlag(color)) {
+        flag = color;
+        color = std::string_view();
+    }
+    else if (!color.empty()) {
+        std::string_view next = nextToken(pos, end);
+        if (isFlag(next)) {
+            flag = next;
+        }
+        else if (!next.empty()) {
+            throw FileParseError(m_filename, m_lineNumber, "Extra data found on line after expected fields.");
+        }
+    }
+
+    //   ,   
+    if (!color.empty()) {
+        m_seenColor = true;
+    }
+    else if (!m_seenColor) {
+        m_leadingInherited++; //       
+    }
+
+    // ,       
+    if (!nextToken(pos, end).empty()) {
+        throw FileParseError(m_filename, m_lineNumber, "Extra data found on line after expected fields.");
+    }
+
+    //     ,     Rectangle:  ,  .
+    //       ,     m_lastColor.
+    try {
+        Rectangle::validateDimensions(w, h);
+        if (!color.empty()) {
+            m_lastColor = Rectangle::colorFromName(color);
+        }
+        //    -  (cx, cy),      (x, y)
+        m_out.push_back(cx - w / 2.0, cy - h / 2.0, w, h, m_lastColor, flag == "1");
+    }
+    catch (const std::invalid_argument& e) {
+        //    Rectangle (, )
+        throw FileParseError(m_filename, m_lineNumber, "Invalid rectangle data: " + std::string(e.what()));
+    }
+    catch (const std::out_of_range& e) {
+        //    Rectangle ( > 1000)
+        throw FileParseError(m_filename, m_lineNumber, "Invalid rectangle data: " + std::string(e.what()));
+    }
+}
+
+// ---   ---
+namespace {
+    //        :    
+    const size_t kMinParallelBytes = 1 << 20;
+    //  ,  ,        
+    const size_t kChunksPerThread = 4;
+
+    //   [begin, end);  ,  ,   '\n'
+    struct Chunk {
+        Chunk() : arena(std::make_unique<std::pmr::monotonic_buffer_resource>()), rectangles(arena.get()) {}
+
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        int firstLine = 0;       //     
+        //      :     
+        // (     ),      
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+        RectangleStore rectangles;
+        std::exception_ptr error; //   
+        bool allInside = true;
+        size_t leadingInherited = 0;
+        bool seenColor = false;
+        Color lastColor = Color::None;
+    };
+
+    //  [data, data + size)       
+    std::vector<Chunk> splitIntoChunks(const char* data, size_t size, size_t chunkCount) {
+        std::vector<Chunk> chunks;
+        const char* end = data + size;
+        const char* begin = data;
+        for (size_t i = 1; i <= chunkCount && begin != end; ++i) {
+            const char* cut = (i == chunkCount) ? end : data + size / chunkCount * i;
+            if (cut < begin) {
+                cut = begin;
+            }
+            if (cut != end) {
+                const char* newline = static_cast<const char*>(
+                    std::memchr(cut, '\n', static_cast<size_t>(end - cut)));
+                cut = newline ? newline + 1 : end;
+            }
+            if (cut == begin) {
+                continue; //      
+            }
+            chunks.emplace_back();
+            chunks.back().begin = begin;
+            chunks.back().end = cut;
+            begin = cut;
+        }
+        return chunks;
+    }
+}
+
+bool parseRectanglesParallel(const std::string& filename, const char* data, size_t size,
+    double width, double height, RectangleStore& out)
+{
+    size_t threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    if (size < kMinParallelBytes) {
+        threadCount = 1;
+    }
+    std::vector<Chunk> chunks = splitIntoChunks(data, size, threadCount == 1 ? 1 : threadCount * kChunksPerThread);
+
+    // 1.     ,        
+    std::vector<int> lineCounts(chunks.size(), 0);
+    runOnThreads(threadCount, chunks.size(), [&](size_t i) {
+        lineCounts[i] = static_cast<int>(std::count(chunks[i].begin, chunks[i].end, '\n'));
+    });
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        chunks[i].firstLine = chunks[i - 1].firstLine + lineCounts[i - 1];
+    }
+
+    // 2.      
+    runOnThreads(threadCount, chunks.size(), [&](size_t i) {
+        Chunk& chunk = chunks[i];
+        try {
+            chunk.rectangles.reserve(static_cast<size_t>(chunk.end - chunk.begin) / kTypicalLineBytes + 1);
+            RectangleFileParser parser(filename, chunk.rectangles, chunk.firstLine);
+            const char* tail = parser.parseLines(chunk.begin, chunk.end);
+            parser.parseLastLine(tail, chunk.end); //      
+
+            chunk.leadingInherited = parser.getLeadingInheritedCount();
+            chunk.seenColor = parser.hasSeenColor();
+            chunk.lastColor = parser.getLastColor();
+            const RectangleStore& rects = chunk.rectangles;
+            for (size_t j = 0; j < rects.size(); ++j) {
+                if (rects.getX(j) < 0 || rects.getY(j) < 0 ||
+                    rects.getX(j) + rects.getWidth(j) > width ||
+                    rects.getY(j) + rects.getHeight(j) > height)
+                {
+                    chunk.allInside = false;
+                    break;
+                }
+            }
+        }
+        catch (...) {
+            chunk.error = std::current_exception();
+        }
+    });
+
+    // 3.       -    .
+    //     ,      .
+    size_t total = 0;
+    bool allInside = true;
+    for (const Chunk& chunk : chunks) {
+        if (chunk.error) {
+            std::rethrow_exception(chunk.error);
+        }
+        total += chunk.rectangles.size();
+        allInside = allInside && chunk.allInside;
+    }
+    if (!allInside) {
+        return false;
+    }
+
+    // 4.    ,      
+    out.reserve(out.size() + total);
+    Color carriedColor = Color::None;
+    for (Chunk& chunk : chunks) {
+        for (size_t i = 0; i < chunk.leadingInherited; ++i) {
+            chunk.rectangles.setColor(i, carriedColor);
+        }
+        if (chunk.seenColor) {
+            carriedColor = chunk.lastColor;
+        }
+        out.append(chunk.rectangles);
+    }
+    return true;
+}
+
+
+// ---   ---
+namespace {
+    //    . read(dst, n)    , 0 -  
+    template <typename Read>
+    void parseBlocks(Read read, RectangleFileParser& parser, size_t bufferSize, const std::function<void()>& onChunk) {
+        std::vector<char> buffer(std::max<size_t>(bufferSize, 1));
+        size_t pending = 0; //      
+
+        while (true) {
+            if (pending == buffer.size()) {
+                buffer.resize(buffer.size() * 2); //    -  
+            }
+            size_t count = read(buffer.data() + pending, buffer.size() - pending);
+            const char* dataEnd = buffer.data() + pending + count;
+            if (count == 0) {
+                //  :   '\n'     
+                parser.parseLastLine(buffer.data(), dataEnd);
+                if (onChunk) {
+                    onChunk();
+                }
+                return;
+            }
+            const char* tail = parser.parseLines(buffer.data(), dataEnd);
+            if (onChunk) {
+                onChunk();
+            }
+
+            //        
+            pending = static_cast<size_t>(dataEnd - tail);
+            if (tail != buffer.data()) {
+                std::copy(tail, dataEnd, buffer.data());
+            }
+        }
+    }
+
+    template <typename Source>
+    size_t streamBatches(Source& source, const std::string& name, const RectangleBatchHandler& onBatch, size_t bufferSize) {
+        RectangleStore batch;
+        RectangleFileParser parser(name, batch);
+        size_t total = 0;
+        parseStream(source, parser, bufferSize, [&]() {
+            if (batch.size() == 0) {
+                return;
+            }
+            //   -   ,       
+            onBatch(batch, static_cast<int>(total) + 1);
+            total += batch.size();
+            batch.clear(); //   
+        });
+        return total;
+    }
+}
+
+void parseStream(std::istream& in, RectangleFileParser& parser, size_t bufferSize, const std::function<void()>& onChunk) {
+    parseBlocks([&](char* data, size_t size) {
+        in.read(data, static_cast<std::streamsize>(size));
+        if (in.bad()) {
+            throw FileParseError(parser.getFilename(), parser.getLineNumber(), "File read error: failed reading from file.");
+        }
+        return static_cast<size_t>(in.gcount());
+    }, parser, bufferSize, onChunk);
+}
+
+void parseStream(int fd, RectangleFileParser& parser, size_t bufferSize, const std::function<void()>& onChunk) {
+    parseBlocks([&](char* data, size_t size) {
+        while (true) {
+#ifdef _WIN32
+            int count = _read(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+#else
+            ssize_t count = ::read(fd, data, size);
+#endif
+            if (count >= 0) {
+                return static_cast<size_t>(count);
+            }
+            if (errno != EINTR) { //     
+                throw FileParseError(parser.getFilename(), parser.getLineNumber(), "File read error: failed reading from file.");
+            }
+        }
+    }, parser, bufferSize, onChunk);
+}
+
+size_t streamRectangles(std::istream& in, const std::string& name, const RectangleBatchHandler& onBatch, size_t bufferSize) {
+    return streamBatches(in, name, onBatch, bufferSize);
+}
+
+size_t streamRectangles(int fd, const std::string& name, const RectangleBatchHandler& onBatch, size_t bufferSize) {
+    return streamBatches(fd, name, onBatch, bufferSize);
+}
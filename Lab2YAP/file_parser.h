@@ -0,0 +1,87 @@
+#pragma once
+
+#include "rectangle_store.h"
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//    :   "cx cy w h [color] [notOverlap]",
+//  notOverlap - 0  1 (  0).
+//    std::from_chars,  -    (   
+//    ),
+// ,   ,    ,   .
+//           
+// (    ;       )
+const size_t kTypicalLineBytes = 20;
+//      
+const size_t kStreamBufferSize = 1 << 20;
+
+class RectangleFileParser {
+public:
+    //    out; filename      .
+    // firstLine -         ( )
+    RectangleFileParser(const std::string& filename, RectangleStore& out, int firstLine = 0);
+
+    //    '\n'   [begin, end).
+    //     (      )
+    const char* parseLines(const char* begin, const char* end);
+
+    //      '\n' (  ,    getline)
+    void parseLastLine(const char* begin, const char* end);
+
+    //    (   ) ,  1
+    int getLineNumber() const noexcept { return m_lineNumber; }
+    const std::string& getFilename() const noexcept { return m_filename; }
+
+    //    :        
+    //      (      )
+    size_t getLeadingInheritedCount() const noexcept { return m_leadingInherited; }
+    bool hasSeenColor() const noexcept { return m_seenColor; }
+    Color getLastColor() const noexcept { return m_lastColor; }
+
+private:
+    const std::string& m_filename;
+    RectangleStore& m_out;
+    Color m_lastColor; //      (     )
+    int m_lineNumber;
+    size_t m_leadingInherited;
+    bool m_seenColor;
+
+    //     '\n'.  FileParseError    ,
+    //        Rectangle
+    void parseLine(const char* begin, const char* end);
+};
+
+//    ,     (, MappedFile).
+//       ,       ,
+//     out   .    
+//      FileParseError  ,     .
+//  false,  -     width x height.
+bool parseRectanglesParallel(const std::string& filename, const char* data, size_t size,
+    double width, double height, RectangleStore& out);
+
+//     bufferSize    ;       
+//     .     onChunk ( ):
+//      ,     .
+//   - FileParseError    
+void parseStream(std::istream& in, RectangleFileParser& parser, size_t bufferSize = kStreamBufferSize,
+    const std::function<void()>& onChunk = {});
+//      (, 0 - stdin  );   
+void parseStream(int fd, RectangleFileParser& parser, size_t bufferSize = kStreamBufferSize,
+    const std::function<void()>& onChunk = {});
+
+//  :       ( 1)   
+using RectangleBatchHandler = std::function<void(const RectangleStore& batch, int firstLine)>;
+
+//      :      ,
+//    -     ,     .
+//    (FileParseError   )  ,   Screen::loadFromFile,
+//      -   ,  .
+// name -     .      .
+//   
+size_t streamRectangles(std::istream& in, const std::string& name, const RectangleBatchHandler& onBatch,
+    size_t bufferSize = kStreamBufferSize);
+size_t streamRectangles(int fd, const std::string& name, const RectangleBatchHandler& onBatch,
+    size_t bufferSize = kStreamBufferSize);
@@ -0,0 +1,103 @@
+#include "free_space.h"
+
+void FreeSpaceMap::reset(double width, double height) {
+    m_free.clear();
+    m_free.push_back({ 0.0, 0.0, width, height });
+}
+
+void FreeSpaceMap::occupy(double x, double y, double w, double h) {
+    const double ox0 = x;
+    const double oy0 = y;
+    const double ox1 = x + w;
+    const double oy1 = y + h;
+
+    //          
+    m_pieces.clear();
+    m_touching.clear();
+    size_t i = 0;
+    while (i < m_free.size()) {
+        Area area = m_free[i];
+        if (!(ox0 < area.x1 && area.x0 < ox1 && oy0 < area.y1 && area.y0 < oy1)) {
+            if (ox0 <= area.x1 && area.x0 <= ox1 && oy0 <= area.y1 && area.y0 <= oy1) {
+                m_touching.push_back(area);
+            }
+            ++i;
+            continue;
+        }
+        if (area.x0 < ox0) {
+            m_pieces.push_back({ area.x0, area.y0, ox0, area.y1 });
+        }
+        if (ox1 < area.x1) {
+            m_pieces.push_back({ ox1, area.y0, area.x1, area.y1 });
+        }
+        if (area.y0 < oy0) {
+            m_pieces.push_back({ area.x0, area.y0, area.x1, oy0 });
+        }
+        if (oy1 < area.y1) {
+            m_pieces.push_back({ area.x0, oy1, area.x1, area.y1 });
+        }
+        m_free[i] = m_free.back(); //    : find   
+        m_free.pop_back();
+    }
+    if (m_pieces.empty()) {
+        return;
+    }
+
+    //       ,      
+    //   (     ).   :
+    //      .      , 
+    //     (   )   :
+    //    ,    
+    for (size_t a = 0; a < m_pieces.size(); ++a) {
+        const Area& piece = m_pieces[a];
+        bool redundant = false;
+        for (size_t b = 0; b < m_pieces.size() && !redundant; ++b) {
+            //     
+            redundant = b != a && m_pieces[b].contains(piece) && (b < a || !piece.contains(m_pieces[b]));
+        }
+        for (size_t b = 0; b < m_touching.size() && !redundant; ++b) {
+            redundant = m_touching[b].contains(piece);
+        }
+        if (!redundant) {
+            m_free.push_back(piece);
+        }
+    }
+}
+
+bool FreeSpaceMap::find(double w, double h, PlacementStrategy strategy, double& x, double& y) const noexcept {
+    const Area* best = nullptr;
+    double bestPrimary = 0;
+    double bestSecondary = 0;
+    for (const Area& area : m_free) {
+        if (!(area.x0 + w <= area.x1 && area.y0 + h <= area.y1)) {
+            continue;
+        }
+        double primary;
+        double secondary;
+        if (strategy == PlacementStrategy::BottomLeft) {
+            primary = area.y0;
+            secondary = area.x0;
+        }
+        else {
+            double leftoverX = area.x1 - area.x0 - w;
+            double leftoverY = area.y1 - area.y0 - h;
+            primary = leftoverX < leftoverY ? leftoverX : leftoverY;
+            secondary = leftoverX < leftoverY ? leftoverY : leftoverX;
+        }
+        //    -  y, x:      
+        if (best == nullptr || primary < bestPrimary ||
+            (primary == bestPrimary && (secondary < bestSecondary ||
+            (secondary == bestSecondary && (area.y0 < best->y0 || (area.y0 == best->y0 && area.x0 < best->x0))))))
+        {
+            best = &area;
+            bestPrimary = primary;
+            bestSecondary = secondary;
+        }
+    }
+    if (best == nullptr) {
+        return false;
+    }
+    x = best->x0;
+    y = best->y0;
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//     Screen::placeRectangle
+enum class PlacementStrategy {
+    //  y,   -  x.  y  ,   SVG,
+    //       
+    BottomLeft,
+    //  ,         
+    // (  -  ):     
+    BestFit
+};
+
+//         (MaxRects):
+//          ,       .
+//    (x0, y0, x1, y1),  x1 -  x + w    
+//  :   x0 + w <= x1   ,    
+//   Screen,       .
+class FreeSpaceMap {
+public:
+    //   ( ); reset   
+    FreeSpaceMap() noexcept = default;
+
+    //   
+    void reset(double width, double height);
+    //  ;       .
+    // O(  );  std::bad_alloc   
+    void occupy(double x, double y, double w, double h);
+    //      w x h; false,   . O(  )
+    bool find(double w, double h, PlacementStrategy strategy, double& x, double& y) const noexcept;
+
+    std::size_t size() const noexcept { return m_free.size(); }
+
+private:
+    struct Area {
+        double x0, y0, x1, y1;
+
+        bool contains(const Area& other) const noexcept {
+            return x0 <= other.x0 && y0 <= other.y0 && other.x1 <= x1 && other.y1 <= y1;
+        }
+    };
+
+    std::vector<Area> m_free;
+    //  occupy ( ):   
+    //   ,   
+    std::vector<Area> m_pieces;
+    std::vector<Area> m_touching;
+};
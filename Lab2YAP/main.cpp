@@ -1,7 +1,14 @@
 #include <iostream>
 #include <vector>
 #include <stdexcept> //    
+#include <array>
+#include <chrono>
+#include <cmath>     //  std::isfinite
+#include <cstdlib>   //  std::strtod
+#include <fstream>
+#include <string_view>
 #include "screen.h"   //  screen.h,   rectangle.h
+#include "file_parser.h" //  streamRectangles
 
 // 9.  noexcept
 void function_that_might_throw() {
@@ -20,7 +27,102 @@ void noexcept_function() noexcept {
 }
 
 
-int main() {
+//  : lab2yap --validate < | -> [ ]
+//        ("-" - stdin),   
+//    .      ; 
+//   notOverlap   -       .
+//   0 -  , 1 -  (  stderr), 2 -  
+int validateFile(int argc, char* argv[]) {
+    if (argc != 3 && argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " --validate <file | -> [width height]" << std::endl;
+        return 2;
+    }
+    bool fromStdin = std::string_view(argv[2]) == "-";
+    std::string name = fromStdin ? "<stdin>" : argv[2];
+    bool checkBounds = argc == 5;
+    //     ("800x" - )  
+    auto parseSide = [](const char* text, double& value) {
+        char* end = nullptr;
+        value = std::strtod(text, &end);
+        return end != text && *end == '\0' && std::isfinite(value);
+    };
+    double width = 0.0;
+    double height = 0.0;
+    if (checkBounds && !(parseSide(argv[3], width) && parseSide(argv[4], height))) {
+        std::cerr << "Invalid screen size: " << argv[3] << " " << argv[4] << std::endl;
+        return 2;
+    }
+    if (checkBounds && !(width > 0 && height > 0)) {
+        std::cerr << "Screen width and height must be positive." << std::endl;
+        return 2;
+    }
+
+    //    ,    
+    std::array<size_t, kColorCount> colorCounts = {};
+    size_t notOverlapCount = 0;
+    size_t outOfBounds = 0;
+    int firstOutOfBoundsLine = 0;
+    double totalArea = 0;
+    auto onBatch = [&](const RectangleStore& batch, int firstLine) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            ++colorCounts[static_cast<size_t>(batch.getColor(i))];
+            notOverlapCount += batch.getNotOverlap(i);
+            totalArea += batch.getWidth(i) * batch.getHeight(i);
+            if (checkBounds && (batch.getX(i) < 0 || batch.getY(i) < 0 ||
+                batch.getX(i) + batch.getWidth(i) > width || batch.getY(i) + batch.getHeight(i) > height))
+            {
+                if (outOfBounds++ == 0) {
+                    firstOutOfBoundsLine = firstLine + static_cast<int>(i);
+                }
+            }
+        }
+    };
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t count = 0;
+    try {
+        if (fromStdin) {
+            count = streamRectangles(0, name, onBatch);
+        }
+        else {
+            std::ifstream in(name, std::ios::in | std::ios::binary);
+            if (!in.is_open()) {
+                throw FileParseError(name, 0, "File read error: unable to open file.");
+            }
+            count = streamRectangles(in, name, onBatch);
+        }
+    }
+    catch (const FileParseError& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Validation failed: " << e.what() << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": " << count << " rectangles, " << notOverlapCount << " with notOverlap, total area "
+        << totalArea << "; " << seconds << " s (" << (seconds > 0 ? count / seconds : 0.0) << " lines/s)\n";
+    for (size_t i = 0; i < kColorCount; ++i) {
+        if (colorCounts[i] > 0) {
+            std::string_view color = Rectangle::colorName(static_cast<Color>(i));
+            std::cout << "  " << (color.empty() ? std::string_view("(no color)") : color) << ": " << colorCounts[i] << "\n";
+        }
+    }
+    if (outOfBounds > 0) {
+        std::cerr << "Error parsing file '" << name << "' at line " << firstOutOfBoundsLine
+            << ": Rectangle loaded from file is out of screen bounds. (" << outOfBounds << " such rectangles)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string_view(argv[1]) == "--validate") {
+        return validateFile(argc, argv);
+    }
+
     // 2.  try/catch 
     try {
         Screen mainScreen(800, 600);
@@ -0,0 +1,103 @@
+#include "mapped_file.h"
+#include <ios> //  std::ios_base::failure
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>    //  open
+#include <sys/mman.h> //  mmap, madvise
+#include <sys/stat.h> //  fstat
+#include <unistd.h>   //  close
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename)
+    : m_data(nullptr), m_size(0), m_mapping(nullptr)
+{
+    // FILE_FLAG_SEQUENTIAL_SCAN -  MADV_SEQUENTIAL   Windows
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::ios_base::failure("unable to open file for mapping");
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::ios_base::failure("unable to query file size");
+    }
+    if (fileSize.QuadPart == 0) {
+        CloseHandle(file); //    ,   
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); //     
+    if (mapping == nullptr) {
+        throw std::ios_base::failure("unable to create file mapping");
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        throw std::ios_base::failure("unable to map file into memory");
+    }
+
+    m_mapping = mapping;
+    m_data = static_cast<const char*>(view);
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename)
+    : m_data(nullptr), m_size(0)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::ios_base::failure("unable to open file for mapping");
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::ios_base::failure("unable to query file size");
+    }
+    if (info.st_size == 0) {
+        ::close(fd); //    ,   
+        return;
+    }
+
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); //     
+    if (view == MAP_FAILED) {
+        throw std::ios_base::failure("unable to map file into memory");
+    }
+
+    //         -    
+    ::madvise(view, size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char*>(view);
+    m_size = size;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// ,       (mmap / MapViewOfFile).
+//    data()/size()     .
+//       std::ios_base::failure,
+//     .
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //    data() == nullptr, size() == 0
+    const char* data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+#ifdef _WIN32
+    void* m_mapping; // HANDLE  
+#endif
+};
@@ -0,0 +1,321 @@
+#include "overlap_kernels.h"
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define LAB2YAP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h> //  __cpuid, _xgetbv
+#endif
+#endif
+
+// GCC  Clang  SIMD-      ;
+// MSVC     
+#if defined(LAB2YAP_X86) && (defined(__GNUC__) || defined(__clang__))
+#define LAB2YAP_TARGET_SSE2 __attribute__((target("sse2")))
+#define LAB2YAP_TARGET_AVX __attribute__((target("avx")))
+#else
+#define LAB2YAP_TARGET_SSE2
+#define LAB2YAP_TARGET_AVX
+#endif
+
+namespace {
+    //     " --",   Rectangle::overlaps:
+    // !(q.x1 <= x0) && !(x1 <= q.x0) && !(q.y1 <= y0) && !(y1 <= q.y0)
+    //   NaN      .
+    inline bool overlapsScalar(double x0, double y0, double x1, double y1, const OverlapQuery& q) noexcept {
+        if (q.x1 <= x0 || x1 <= q.x0) {
+            return false;
+        }
+        if (q.y1 <= y0 || y1 <= q.y0) {
+            return false;
+        }
+        return true;
+    }
+
+    //      () 
+    inline unsigned laneMask(std::size_t lanes) noexcept {
+        return (1u << lanes) - 1u;
+    }
+
+    // ---   ---
+    bool anyOverlapInBlocksScalar(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& q) noexcept {
+        for (std::size_t i = 0; i < entryCount; ++i) {
+            const OverlapBlock& b = blocks[i / 4];
+            std::size_t lane = i % 4;
+            if (overlapsScalar(b.x0[lane], b.y0[lane], b.x1[lane], b.y1[lane], q)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t collectOverlapsScalar(const double* xs, const double* ys, const double* ws, const double* hs,
+        std::size_t count, const OverlapQuery& q, std::uint32_t* out) noexcept
+    {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (overlapsScalar(xs[i], ys[i], xs[i] + ws[i], ys[i] + hs[i], q)) {
+                out[found++] = static_cast<std::uint32_t>(i);
+            }
+        }
+        return found;
+    }
+
+#ifdef LAB2YAP_X86
+    // --- SSE2:  2    ---
+    LAB2YAP_TARGET_SSE2
+    bool anyOverlapInBlocksSse2(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& q) noexcept {
+        const __m128d qx0 = _mm_set1_pd(q.x0);
+        const __m128d qy0 = _mm_set1_pd(q.y0);
+        const __m128d qx1 = _mm_set1_pd(q.x1);
+        const __m128d qy1 = _mm_set1_pd(q.y1);
+        std::size_t blockCount = (entryCount + 3) / 4;
+        for (std::size_t i = 0; i < blockCount; ++i) {
+            const OverlapBlock& b = blocks[i];
+            unsigned mask = 0;
+            for (int half = 0; half < 4; half += 2) {
+                __m128d hit = _mm_and_pd(
+                    _mm_and_pd(_mm_cmpnle_pd(qx1, _mm_loadu_pd(b.x0 + half)), _mm_cmpnle_pd(_mm_loadu_pd(b.x1 + half), qx0)),
+                    _mm_and_pd(_mm_cmpnle_pd(qy1, _mm_loadu_pd(b.y0 + half)), _mm_cmpnle_pd(_mm_loadu_pd(b.y1 + half), qy0)));
+                mask |= static_cast<unsigned>(_mm_movemask_pd(hit)) << half;
+            }
+            if (i + 1 == blockCount && entryCount % 4 != 0) {
+                mask &= laneMask(entryCount % 4);
+            }
+            if (mask != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    LAB2YAP_TARGET_SSE2
+    std::size_t collectOverlapsSse2(const double* xs, const double* ys, const double* ws, const double* hs,
+        std::size_t count, const OverlapQuery& q, std::uint32_t* out) noexcept
+    {
+        const __m128d qx0 = _mm_set1_pd(q.x0);
+        const __m128d qy0 = _mm_set1_pd(q.y0);
+        const __m128d qx1 = _mm_set1_pd(q.x1);
+        const __m128d qy1 = _mm_set1_pd(q.y1);
+        std::size_t found = 0;
+        std::size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m128d x = _mm_loadu_pd(xs + i);
+            __m128d y = _mm_loadu_pd(ys + i);
+            __m128d x1 = _mm_add_pd(x, _mm_loadu_pd(ws + i));
+            __m128d y1 = _mm_add_pd(y, _mm_loadu_pd(hs + i));
+            __m128d hit = _mm_and_pd(
+                _mm_and_pd(_mm_cmpnle_pd(qx1, x), _mm_cmpnle_pd(x1, qx0)),
+                _mm_and_pd(_mm_cmpnle_pd(qy1, y), _mm_cmpnle_pd(y1, qy0)));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_pd(hit));
+            if (mask & 1u) out[found++] = static_cast<std::uint32_t>(i);
+            if (mask & 2u) out[found++] = static_cast<std::uint32_t>(i + 1);
+        }
+        for (; i < count; ++i) {
+            if (overlapsScalar(xs[i], ys[i], xs[i] + ws[i], ys[i] + hs[i], q)) {
+                out[found++] = static_cast<std::uint32_t>(i);
+            }
+        }
+        return found;
+    }
+
+    // --- AVX:  4    ---
+    LAB2YAP_TARGET_AVX
+    bool anyOverlapInBlocksAvx(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& q) noexcept {
+        const __m256d qx0 = _mm256_set1_pd(q.x0);
+        const __m256d qy0 = _mm256_set1_pd(q.y0);
+        const __m256d qx1 = _mm256_set1_pd(q.x1);
+        const __m256d qy1 = _mm256_set1_pd(q.y1);
+        std::size_t blockCount = (entryCount + 3) / 4;
+        for (std::size_t i = 0; i < blockCount; ++i) {
+            const OverlapBlock& b = blocks[i];
+            __m256d hit = _mm256_and_pd(
+                _mm256_and_pd(_mm256_cmp_pd(qx1, _mm256_loadu_pd(b.x0), _CMP_NLE_UQ),
+                    _mm256_cmp_pd(_mm256_loadu_pd(b.x1), qx0, _CMP_NLE_UQ)),
+                _mm256_and_pd(_mm256_cmp_pd(qy1, _mm256_loadu_pd(b.y0), _CMP_NLE_UQ),
+                    _mm256_cmp_pd(_mm256_loadu_pd(b.y1), qy0, _CMP_NLE_UQ)));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(hit));
+            if (i + 1 == blockCount && entryCount % 4 != 0) {
+                mask &= laneMask(entryCount % 4);
+            }
+            if (mask != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    LAB2YAP_TARGET_AVX
+    std::size_t collectOverlapsAvx(const double* xs, const double* ys, const double* ws, const double* hs,
+        std::size_t count, const OverlapQuery& q, std::uint32_t* out) noexcept
+    {
+        const __m256d qx0 = _mm256_set1_pd(q.x0);
+        const __m256d qy0 = _mm256_set1_pd(q.y0);
+        const __m256d qx1 = _mm256_set1_pd(q.x1);
+        const __m256d qy1 = _mm256_set1_pd(q.y1);
+        std::size_t found = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256d x = _mm256_loadu_pd(xs + i);
+            __m256d y = _mm256_loadu_pd(ys + i);
+            __m256d x1 = _mm256_add_pd(x, _mm256_loadu_pd(ws + i));
+            __m256d y1 = _mm256_add_pd(y, _mm256_loadu_pd(hs + i));
+            __m256d hit = _mm256_and_pd(
+                _mm256_and_pd(_mm256_cmp_pd(qx1, x, _CMP_NLE_UQ), _mm256_cmp_pd(x1, qx0, _CMP_NLE_UQ)),
+                _mm256_and_pd(_mm256_cmp_pd(qy1, y, _CMP_NLE_UQ), _mm256_cmp_pd(y1, qy0, _CMP_NLE_UQ)));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(hit));
+            while (mask != 0) {
+                unsigned lane = 0;
+                while (!(mask & (1u << lane))) {
+                    ++lane;
+                }
+                out[found++] = static_cast<std::uint32_t>(i + lane);
+                mask &= mask - 1; //    
+            }
+        }
+        for (; i < count; ++i) {
+            if (overlapsScalar(xs[i], ys[i], xs[i] + ws[i], ys[i] + hs[i], q)) {
+                out[found++] = static_cast<std::uint32_t>(i);
+            }
+        }
+        return found;
+    }
+
+    // ---    ---
+#if defined(_MSC_VER)
+    bool cpuHasSse2() noexcept {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+    }
+
+    bool cpuHasAvx() noexcept {
+        int info[4];
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) != 0; // OSXSAVE
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osSavesYmm || !avx) {
+            return false;
+        }
+        return (_xgetbv(0) & 0x6) == 0x6; //    XMM  YMM
+    }
+#else
+    bool cpuHasSse2() noexcept {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    }
+
+    bool cpuHasAvx() noexcept {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx");
+    }
+#endif
+#endif // LAB2YAP_X86
+
+    bool kernelSupported(OverlapKernel kernel) noexcept {
+        switch (kernel) {
+        case OverlapKernel::Scalar:
+            return true;
+#ifdef LAB2YAP_X86
+        case OverlapKernel::Sse2:
+            return cpuHasSse2();
+        case OverlapKernel::Avx:
+            return cpuHasAvx();
+#endif
+        default:
+            return false;
+        }
+    }
+
+    OverlapKernel detectBestKernel() noexcept {
+        if (kernelSupported(OverlapKernel::Avx)) {
+            return OverlapKernel::Avx;
+        }
+        if (kernelSupported(OverlapKernel::Sse2)) {
+            return OverlapKernel::Sse2;
+        }
+        return OverlapKernel::Scalar;
+    }
+
+    //  ;    , selectOverlapKernel 
+    //  ,    (ConcurrentScreen,  )  .
+    //       ,    relaxed
+    std::atomic<OverlapKernel> g_kernel{ detectBestKernel() };
+}
+
+bool anyOverlapInBlocks(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& query) noexcept {
+#ifdef LAB2YAP_X86
+    OverlapKernel kernel = g_kernel.load(std::memory_order_relaxed);
+    if (kernel == OverlapKernel::Avx) {
+        return anyOverlapInBlocksAvx(blocks, entryCount, query);
+    }
+    if (kernel == OverlapKernel::Sse2) {
+        return anyOverlapInBlocksSse2(blocks, entryCount, query);
+    }
+#endif
+    return anyOverlapInBlocksScalar(blocks, entryCount, query);
+}
+
+std::size_t collectOverlaps(const double* xs, const double* ys, const double* ws, const double* hs,
+    std::size_t count, const OverlapQuery& query, std::uint32_t* out) noexcept
+{
+#ifdef LAB2YAP_X86
+    OverlapKernel kernel = g_kernel.load(std::memory_order_relaxed);
+    if (kernel == OverlapKernel::Avx) {
+        return collectOverlapsAvx(xs, ys, ws, hs, count, query, out);
+    }
+    if (kernel == OverlapKernel::Sse2) {
+        return collectOverlapsSse2(xs, ys, ws, hs, count, query, out);
+    }
+#endif
+    return collectOverlapsScalar(xs, ys, ws, hs, count, query, out);
+}
+
+std::size_t firstOverlapInBlocks(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& query) noexcept {
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        const OverlapBlock& b = blocks[i / 4];
+        std::size_t lane = i % 4;
+        if (overlapsScalar(b.x0[lane], b.y0[lane], b.x1[lane], b.y1[lane], query)) {
+            return i;
+        }
+    }
+    return entryCount;
+}
+
+std::size_t collectOverlapsInBlocks(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& query,
+    std::size_t* out) noexcept
+{
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        const OverlapBlock& b = blocks[i / 4];
+        std::size_t lane = i % 4;
+        if (overlapsScalar(b.x0[lane], b.y0[lane], b.x1[lane], b.y1[lane], query)) {
+            out[found++] = i;
+        }
+    }
+    return found;
+}
+
+OverlapKernel activeOverlapKernel() noexcept {
+    return g_kernel.load(std::memory_order_relaxed);
+}
+
+const char* overlapKernelName(OverlapKernel kernel) noexcept {
+    switch (kernel) {
+    case OverlapKernel::Sse2:
+        return "sse2";
+    case OverlapKernel::Avx:
+        return "avx";
+    default:
+        return "scalar";
+    }
+}
+
+bool selectOverlapKernel(OverlapKernel kernel) noexcept {
+    if (!kernelSupported(kernel)) {
+        return false;
+    }
+    g_kernel.store(kernel, std::memory_order_relaxed);
+    return true;
+}
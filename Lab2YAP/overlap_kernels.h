@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// SIMD-     .
+//   ,   Rectangle::overlaps (  -  ),
+//    :        .
+//       : AVX (4 double  ),
+// SSE2 (2 double)    .
+
+//   [x0, x1) x [y0, y1),  x1 = x + w, y1 = y + h
+struct OverlapQuery {
+    double x0;
+    double y0;
+    double x1;
+    double y1;
+};
+
+//     "  ":   -  
+//  .   SpatialGrid.    ( loadu),
+//      operator new.
+struct OverlapBlock {
+    double x0[4];
+    double y0[4];
+    double x1[4];
+    double y1[4];
+    //     ;    .   size_t:  Screen 
+    //     clear(),       32   
+    std::size_t id[4];
+};
+
+enum class OverlapKernel {
+    Scalar,
+    Sse2,
+    Avx
+};
+
+//     entryCount    ,   query
+bool anyOverlapInBlocks(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& query) noexcept;
+
+//  (0..entryCount-1)   ,   query,  entryCount,   .
+//  :     ,    
+std::size_t firstOverlapInBlocks(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& query) noexcept;
+
+//   out  (0..entryCount-1)   ,   query;
+//   .  out     entryCount 
+std::size_t collectOverlapsInBlocks(const OverlapBlock* blocks, std::size_t entryCount, const OverlapQuery& query,
+    std::size_t* out) noexcept;
+
+//   out  (0..count-1)     x, y, w, h,
+//   query;   .  out     count .
+std::size_t collectOverlaps(const double* xs, const double* ys, const double* ws, const double* hs,
+    std::size_t count, const OverlapQuery& query, std::uint32_t* out) noexcept;
+
+//    
+OverlapKernel activeOverlapKernel() noexcept;
+const char* overlapKernelName(OverlapKernel kernel) noexcept;
+
+//    ( ). false,     .
+//     :      
+bool selectOverlapKernel(OverlapKernel kernel) noexcept;
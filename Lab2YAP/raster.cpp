@@ -0,0 +1,237 @@
+#include "raster.h"
+#include "screen.h"
+#include "thread_pool.h"
+#include <algorithm> //  std::max, std::min, std::fill_n
+#include <array>
+#include <cmath>     //  std::ceil, std::isnan
+#include <cstring>   //  std::memcpy
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LAB2YAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    //   ,  :        
+    const std::size_t kBandsPerThread = 4;
+    const std::size_t kMinBandRows = 16;
+
+    //     SVG ( -  Color);  - lightgrey
+    const std::array<std::array<std::uint8_t, 3>, kColorCount> kPaletteRgb = { {
+        { 0, 0, 0 },       // None:  
+        { 255, 0, 0 },     // red
+        { 0, 128, 0 },     // green
+        { 0, 0, 255 },     // blue
+        { 255, 255, 0 },   // yellow
+        { 0, 0, 0 },       // black
+        { 255, 255, 255 }, // white
+        { 128, 0, 128 },   // purple
+        { 255, 165, 0 }    // orange
+    } };
+    const std::array<std::uint8_t, 3> kBackgroundRgb = { 211, 211, 211 };
+
+    //   [x0, x1) x [y0, y1)
+    struct PixelBox {
+        std::size_t x0;
+        std::size_t y0;
+        std::size_t x1;
+        std::size_t y1;
+    };
+
+    //     [a, b),   [0, size); false,   
+    bool toPixelRange(double a, double b, std::size_t size, std::size_t& first, std::size_t& last) noexcept {
+        if (std::isnan(a) || std::isnan(b)) {
+            return false;
+        }
+        double lo = std::max(0.0, std::ceil(a - 0.5));
+        double hi = std::min(static_cast<double>(size), std::ceil(b - 0.5));
+        if (!(lo < hi)) {
+            return false;
+        }
+        first = static_cast<std::size_t>(lo);
+        last = static_cast<std::size_t>(hi);
+        return true;
+    }
+
+    bool toPixelBox(double x0, double y0, double x1, double y1, std::size_t width, std::size_t height,
+        PixelBox& box) noexcept
+    {
+        return toPixelRange(x0, x1, width, box.x0, box.x1) && toPixelRange(y0, y1, height, box.y0, box.y1);
+    }
+
+    //     :  4    SSE2
+    void fillSpan(std::uint32_t* pixels, std::size_t count, std::uint32_t value) noexcept {
+#ifdef LAB2YAP_SSE2
+        const __m128i fill = _mm_set1_epi32(static_cast<int>(value));
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), fill);
+        }
+        for (; i < count; ++i) {
+            pixels[i] = value;
+        }
+#else
+        std::fill_n(pixels, count, value);
+#endif
+    }
+
+    //  box   [bandY0, bandY1)
+    void fillBox(Framebuffer& frame, const PixelBox& box, std::size_t bandY0, std::size_t bandY1,
+        std::uint32_t value) noexcept
+    {
+        std::size_t y0 = std::max(box.y0, bandY0);
+        std::size_t y1 = std::min(box.y1, bandY1);
+        for (std::size_t y = y0; y < y1; ++y) {
+            fillSpan(frame.row(y) + box.x0, box.x1 - box.x0, value);
+        }
+    }
+
+    //  i     [bandY0, bandY1)
+    void drawRectangle(Framebuffer& frame, const RectangleStore& rects, std::size_t i,
+        std::size_t bandY0, std::size_t bandY1) noexcept
+    {
+        double x0 = rects.getX(i);
+        double y0 = rects.getY(i);
+        double x1 = x0 + rects.getWidth(i);
+        double y1 = y0 + rects.getHeight(i);
+        Color color = rects.getColor(i);
+        std::uint32_t value = colorToRgba(color);
+        std::size_t width = frame.getWidth();
+        std::size_t height = frame.getHeight();
+        PixelBox box;
+
+        if (color != Color::None) {
+            if (toPixelBox(x0, y0, x1, y1, width, height, box)) {
+                fillBox(frame, box, bandY0, bandY1, value);
+            }
+            return;
+        }
+        //   -  stroke-width="1"   :     
+        const double half = 0.5;
+        if (toPixelBox(x0 - half, y0 - half, x1 + half, y0 + half, width, height, box)) {
+            fillBox(frame, box, bandY0, bandY1, value); // 
+        }
+        if (toPixelBox(x0 - half, y1 - half, x1 + half, y1 + half, width, height, box)) {
+            fillBox(frame, box, bandY0, bandY1, value); // 
+        }
+        if (toPixelBox(x0 - half, y0 - half, x0 + half, y1 + half, width, height, box)) {
+            fillBox(frame, box, bandY0, bandY1, value); //  
+        }
+        if (toPixelBox(x1 - half, y0 - half, x1 + half, y1 + half, width, height, box)) {
+            fillBox(frame, box, bandY0, bandY1, value); //  
+        }
+    }
+
+    std::size_t frameSide(double size) noexcept {
+        return size > 0 ? static_cast<std::size_t>(std::ceil(size)) : 0;
+    }
+}
+
+Framebuffer::Framebuffer(std::size_t width, std::size_t height, std::uint32_t fill)
+    : m_width(width), m_height(height), m_pixels(width * height, fill) {}
+
+std::uint32_t Framebuffer::rgba(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a) noexcept {
+    const std::uint8_t bytes[4] = { r, g, b, a };
+    std::uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+void Framebuffer::savePPM(const std::string& filename) const {
+    save(filename, false);
+}
+
+void Framebuffer::savePAM(const std::string& filename) const {
+    save(filename, true);
+}
+
+void Framebuffer::save(const std::string& filename, bool withAlpha) const {
+    try {
+        std::ofstream out;
+        out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        out.open(filename, std::ios::out | std::ios::binary);
+
+        std::string header;
+        if (withAlpha) {
+            header = "P7\nWIDTH " + std::to_string(m_width) + "\nHEIGHT " + std::to_string(m_height) +
+                "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+        }
+        else {
+            header = "P6\n" + std::to_string(m_width) + " " + std::to_string(m_height) + "\n255\n";
+        }
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+        if (withAlpha) {
+            //        R, G, B, A
+            out.write(reinterpret_cast<const char*>(m_pixels.data()),
+                static_cast<std::streamsize>(m_pixels.size() * sizeof(std::uint32_t)));
+        }
+        else {
+            std::vector<char> line(m_width * 3);
+            for (std::size_t y = 0; y < m_height; ++y) {
+                const std::uint32_t* pixels = row(y);
+                for (std::size_t x = 0; x < m_width; ++x) {
+                    std::memcpy(line.data() + x * 3, pixels + x, 3); // R, G, B  A
+                }
+                out.write(line.data(), static_cast<std::streamsize>(line.size()));
+            }
+        }
+        out.flush();
+    }
+    catch (const std::ios_base::failure& e) {
+        throw std::runtime_error("Error saving image file '" + filename + "': " + e.what());
+    }
+}
+
+std::uint32_t colorToRgba(Color color) noexcept {
+    std::size_t index = static_cast<std::size_t>(color);
+    const std::array<std::uint8_t, 3>& rgb = kPaletteRgb[index < kPaletteRgb.size() ? index : 0];
+    return Framebuffer::rgba(rgb[0], rgb[1], rgb[2]);
+}
+
+Framebuffer renderScreen(const Screen& screen, std::size_t threadCount) {
+    Framebuffer frame(frameSide(screen.getWidth()), frameSide(screen.getHeight()),
+        Framebuffer::rgba(kBackgroundRgb[0], kBackgroundRgb[1], kBackgroundRgb[2]));
+    const RectangleStore& rects = screen.getRectangles();
+    if (frame.getWidth() == 0 || frame.getHeight() == 0 || rects.empty()) {
+        return frame;
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    std::size_t bandRows = std::max(kMinBandRows,
+        (frame.getHeight() + threadCount * kBandsPerThread - 1) / (threadCount * kBandsPerThread));
+    std::size_t bandCount = (frame.getHeight() + bandRows - 1) / bandRows;
+
+    //    ,    (  ),
+    //   :       
+    std::vector<std::vector<std::uint32_t>> bands(bandCount);
+    for (std::size_t i = 0; i < rects.size(); ++i) {
+        if (rects.isRemoved(i)) {
+            continue;
+        }
+        double y0 = rects.getY(i) - 0.5;
+        double y1 = rects.getY(i) + rects.getHeight(i) + 0.5;
+        std::size_t first, last;
+        if (!toPixelRange(y0, y1, frame.getHeight(), first, last)) {
+            continue;
+        }
+        for (std::size_t band = first / bandRows; band <= (last - 1) / bandRows; ++band) {
+            bands[band].push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+    //     ,       
+    runOnThreads(std::min(threadCount, bandCount), bandCount, [&](std::size_t band) {
+        std::size_t bandY0 = band * bandRows;
+        std::size_t bandY1 = std::min(frame.getHeight(), bandY0 + bandRows);
+        for (std::uint32_t i : bands[band]) {
+            drawRectangle(frame, rects, i, bandY0, bandY1);
+        }
+    });
+    return frame;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "rectangle.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Screen;
+
+//  RGBA:  - 4  R, G, B, A  ( std::uint32_t),   .
+class Framebuffer {
+public:
+    Framebuffer(std::size_t width, std::size_t height, std::uint32_t fill = 0);
+
+    //    (    R, G, B, A   )
+    static std::uint32_t rgba(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a = 255) noexcept;
+
+    std::size_t getWidth() const noexcept { return m_width; }
+    std::size_t getHeight() const noexcept { return m_height; }
+
+    std::uint32_t* row(std::size_t y) noexcept { return m_pixels.data() + y * m_width; }
+    const std::uint32_t* row(std::size_t y) const noexcept { return m_pixels.data() + y * m_width; }
+    std::uint32_t getPixel(std::size_t x, std::size_t y) const noexcept { return row(y)[x]; }
+
+    //    .   - std::runtime_error,   Screen::saveSVG
+    void savePPM(const std::string& filename) const; // P6: RGB,  
+    void savePAM(const std::string& filename) const; // P7 RGB_ALPHA
+
+private:
+    std::size_t m_width;
+    std::size_t m_height;
+    std::vector<std::uint32_t> m_pixels;
+
+    void save(const std::string& filename, bool withAlpha) const;
+};
+
+//      (  ,    SVG).  Color::None -  
+std::uint32_t colorToRgba(Color color) noexcept;
+
+//      ceil() x ceil(),   ,  saveSVG:
+// - ,     (  ),
+//    -    .
+//  ,     .
+//     ,    threadCount  (0 -   );
+//   SIMD-.
+Framebuffer renderScreen(const Screen& screen, std::size_t threadCount = 0);
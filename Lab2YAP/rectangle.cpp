@@ -1,58 +1,145 @@
 #include "rectangle.h"
 #include <stdexcept>
-#include <algorithm> //  std::find
-#include <vector>
+#include <array>
 #include <iostream> //    SVG
 
-//     
-//    
-const std::vector<std::string> Rectangle::allowedColors = {
-    "red", "green", "blue", "yellow", "black", "white", "purple", "orange"
-};
+//   :     Color
+//     (  enum Color)
+namespace {
+    constexpr std::array<std::string_view, kColorCount> kColorNames = {
+        "", "red", "green", "blue", "yellow", "black", "white", "purple", "orange"
+    };
+
+    //  -   :      .
+    //      ,  static_assert .
+    constexpr std::size_t kColorSlots = 16;
+    constexpr std::size_t colorSlot(std::string_view name) noexcept {
+        return (4u * static_cast<unsigned char>(name.front())
+            + 7u * static_cast<unsigned char>(name.back())
+            + name.size()) & (kColorSlots - 1);
+    }
+
+    //   -> ;    Color::None
+    constexpr std::array<Color, kColorSlots> makeColorSlots() noexcept {
+        std::array<Color, kColorSlots> slots{};
+        for (std::size_t i = 1; i < kColorNames.size(); ++i) {
+            slots[colorSlot(kColorNames[i])] = static_cast<Color>(i);
+        }
+        return slots;
+    }
+    constexpr std::array<Color, kColorSlots> kColorBySlot = makeColorSlots();
+
+    constexpr bool colorSlotsArePerfect() noexcept {
+        for (std::size_t i = 1; i < kColorNames.size(); ++i) {
+            if (kColorBySlot[colorSlot(kColorNames[i])] != static_cast<Color>(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(colorSlotsArePerfect(), "Color names collide in colorSlot(), adjust the hash");
+
+    //   : true    result,   
+    bool lookupColor(std::string_view name, Color& result) noexcept {
+        if (name.empty()) { //   
+            result = Color::None;
+            return true;
+        }
+        Color candidate = kColorBySlot[colorSlot(name)];
+        if (candidate == Color::None || kColorNames[static_cast<std::size_t>(candidate)] != name) {
+            return false;
+        }
+        result = candidate;
+        return true;
+    }
+}
+
+const char* const kNonPositiveSizeError = "Rectangle dimensions (width, height) must be positive.";
+const char* const kTooLargeSizeError = "Rectangle dimensions (width, height) must not exceed 1000.";
+const char* const kInvalidColorError = "Invalid color value. Must be one of the Color enumerators.";
 
 // ---  ---
 void Rectangle::validateDimensions(double w, double h) {
     if (w <= 0 || h <= 0) {
-        throw std::invalid_argument("Rectangle dimensions (width, height) must be positive.");
+        throw std::invalid_argument(kNonPositiveSizeError);
     }
     if (w > 1000 || h > 1000) {
         //        
-        throw std::out_of_range("Rectangle dimensions (width, height) must not exceed 1000.");
+        throw std::out_of_range(kTooLargeSizeError);
     }
 }
 
-void Rectangle::validateColor(const std::string& color) {
-    if (color.empty()) { //   
-        return;
+const char* Rectangle::dimensionsError(double w, double h) noexcept {
+    if (w <= 0 || h <= 0) {
+        return kNonPositiveSizeError;
     }
-    //     
-    //  std::find  
-    if (std::find(allowedColors.begin(), allowedColors.end(), color) == allowedColors.end()) {
-        throw std::invalid_argument("Invalid color specified: " + color + ". Must be one of the allowed colors or empty.");
+    if (w > 1000 || h > 1000) {
+        return kTooLargeSizeError;
     }
+    return nullptr;
+}
+
+void Rectangle::validateColor(std::string_view color) {
+    colorFromName(color);
+}
+
+void Rectangle::validateColor(Color color) {
+    if (!isValidColor(color)) {
+        throw std::invalid_argument(kInvalidColorError);
+    }
+}
+
+// ---  ---
+Color Rectangle::colorFromName(std::string_view name) {
+    //          
+    Color result;
+    if (!lookupColor(name, result)) {
+        throw std::invalid_argument("Invalid color specified: " + std::string(name) + ". Must be one of the allowed colors or empty.");
+    }
+    return result;
+}
+
+std::string_view Rectangle::colorName(Color color) noexcept {
+    std::size_t index = static_cast<std::size_t>(color);
+    return index < kColorNames.size() ? kColorNames[index] : std::string_view();
 }
 
 // ---  ---
-Rectangle::Rectangle(double x, double y, double w, double h, std::string color, bool notOverlap)
-    : m_x(x), m_y(y), m_width(0), m_height(0), m_color(""), m_notOverlap(notOverlap) //     
+Rectangle::Rectangle(double x, double y, double w, double h, std::string_view color, bool notOverlap)
+    : m_x(x), m_y(y), m_width(0), m_height(0), m_color(Color::None), m_notOverlap(notOverlap) //     
 {
     // 1.  
     validateDimensions(w, h);
-    // 2.  
-    validateColor(color);
+    // 2.   (    Color)
+    Color parsedColor = colorFromName(color);
 
     //    ,  
     m_width = w;
     m_height = h;
-    m_color = color;
+    m_color = parsedColor;
     // m_x, m_y, m_notOverlap  
 }
 
+Rectangle::Rectangle(double x, double y, double w, double h, Color color, bool notOverlap)
+    : m_x(x), m_y(y), m_width(0), m_height(0), m_color(Color::None), m_notOverlap(notOverlap)
+{
+    //   ,     :     
+    validateDimensions(w, h);
+    validateColor(color);
+    m_width = w;
+    m_height = h;
+    m_color = color;
+}
+
 // ---  ---
-void Rectangle::setColor(const std::string& color) {
+void Rectangle::setColor(std::string_view color) {
     // 3.     
+    m_color = colorFromName(color); // ,    
+}
+
+void Rectangle::setColor(Color color) {
     validateColor(color);
-    m_color = color; // ,    
+    m_color = color;
 }
 
 // 7.   (,   )
@@ -73,8 +160,8 @@ bool Rectangle::overlaps(const Rectangle& other) const noexcept {
 void Rectangle::drawSVG(std::ostream& out) const {
     out << "  <rect x=\"" << m_x << "\" y=\"" << m_y
         << "\" width=\"" << m_width << "\" height=\"" << m_height << "\"";
-    if (!m_color.empty()) {
-        out << " fill=\"" << m_color << "\"";
+    if (m_color != Color::None) {
+        out << " fill=\"" << colorName(m_color) << "\"";
     }
     else {
         out << " fill=\"none\" stroke=\"black\""; //   ,  
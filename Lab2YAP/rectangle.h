@@ -1,22 +1,50 @@
 #pragma once //    
 
 #include <string>
-#include <vector>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
 #include <stdexcept> //   
 #include <ostream>   //  drawSVG
 
+//  .     ,   .
+// None -    (  )
+enum class Color : std::uint8_t {
+    None = 0,
+    Red, Green, Blue, Yellow, Black, White, Purple, Orange
+};
+const std::size_t kColorCount = 9; //   Color,  None
+
+//     (validateDimensions, dimensionsError)
+extern const char* const kNonPositiveSizeError;
+extern const char* const kTooLargeSizeError;
+//     Color   (validateColor(Color))
+extern const char* const kInvalidColorError;
+
 class Rectangle {
 public:
     // ---  ---
     //   notOverlap    
-    Rectangle(double x, double y, double w, double h, std::string color = "", bool notOverlap = false);
+    Rectangle(double x, double y, double w, double h, std::string_view color = {}, bool notOverlap = false);
+    Rectangle(double x, double y, double w, double h, Color color, bool notOverlap = false);
 
     // ---  (,      setColor) ---
     static void validateDimensions(double w, double h);
-    static void validateColor(const std::string& color);
+    //    :   ( )  nullptr,   
+    static const char* dimensionsError(double w, double h) noexcept;
+    static void validateColor(std::string_view color);
+    //  Color,   ,    :
+    //    ,    (std::invalid_argument)
+    static void validateColor(Color color);
+    static bool isValidColor(Color color) noexcept { return static_cast<std::size_t>(color) < kColorCount; }
+
+    // --- :    Color  , O(1)    ---
+    static Color colorFromName(std::string_view name); // ,  validateColor
+    static std::string_view colorName(Color color) noexcept; //  Color::None -  
 
     // ---  ---
-    void setColor(const std::string& color);
+    void setColor(std::string_view color);
+    void setColor(Color color);
     bool overlaps(const Rectangle& other) const noexcept; //  
     void drawSVG(std::ostream& out) const; //   SVG 
 
@@ -25,7 +53,8 @@ public:
     double getY() const noexcept { return m_y; }
     double getWidth() const noexcept { return m_width; }
     double getHeight() const noexcept { return m_height; }
-    std::string getColor() const noexcept { return m_color; }
+    std::string_view getColor() const noexcept { return colorName(m_color); } //   
+    Color getColorId() const noexcept { return m_color; }
     bool getNotOverlap() const noexcept { return m_notOverlap; }
 
 private:
@@ -33,9 +62,6 @@ private:
     double m_y;
     double m_width;
     double m_height;
-    std::string m_color;
+    Color m_color;
     bool m_notOverlap; //    
-
-    //    
-    static const std::vector<std::string> allowedColors;
 };
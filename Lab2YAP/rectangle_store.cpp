@@ -0,0 +1,96 @@
+#include "rectangle_store.h"
+#include <algorithm> //  std::max, std::min
+
+Rectangle RectangleStore::operator[](std::size_t index) const {
+    return Rectangle(m_x[index], m_y[index], m_width[index], m_height[index],
+        m_color[index], getNotOverlap(index));
+}
+
+std::size_t RectangleStore::capacity() const noexcept {
+    return std::min({ m_x.capacity(), m_y.capacity(), m_width.capacity(), m_height.capacity(),
+        m_color.capacity(), m_flags.capacity() });
+}
+
+void RectangleStore::reserve(std::size_t count) {
+    //  reserve  ,       ,
+    //     .    ,
+    //  capacity() -   
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_width.reserve(count);
+    m_height.reserve(count);
+    m_color.reserve(count);
+    m_flags.reserve(count);
+}
+
+void RectangleStore::push_back(double x, double y, double w, double h, Color color, bool notOverlap) {
+    if (size() == capacity()) {
+        reserve(std::max<std::size_t>(16, m_x.size() * 2));
+    }
+    //      -    
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_width.push_back(w);
+    m_height.push_back(h);
+    m_color.push_back(color);
+    m_flags.push_back(notOverlap ? kNotOverlap : 0);
+}
+
+void RectangleStore::push_back(const Rectangle& rect) {
+    push_back(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(),
+        rect.getColorId(), rect.getNotOverlap());
+}
+
+void RectangleStore::append(const RectangleStore& other) {
+    reserve(size() + other.size());
+    m_x.insert(m_x.end(), other.m_x.begin(), other.m_x.end());
+    m_y.insert(m_y.end(), other.m_y.begin(), other.m_y.end());
+    m_width.insert(m_width.end(), other.m_width.begin(), other.m_width.end());
+    m_height.insert(m_height.end(), other.m_height.begin(), other.m_height.end());
+    m_color.insert(m_color.end(), other.m_color.begin(), other.m_color.end());
+    m_flags.insert(m_flags.end(), other.m_flags.begin(), other.m_flags.end());
+}
+
+void RectangleStore::appendColumns(const double* x, const double* y, const double* w, const double* h,
+    const Color* colors, const std::uint8_t* flags, std::size_t count)
+{
+    reserve(size() + count);
+    m_x.insert(m_x.end(), x, x + count);
+    m_y.insert(m_y.end(), y, y + count);
+    m_width.insert(m_width.end(), w, w + count);
+    m_height.insert(m_height.end(), h, h + count);
+    m_color.insert(m_color.end(), colors, colors + count);
+    m_flags.insert(m_flags.end(), flags, flags + count);
+}
+
+void RectangleStore::truncate(std::size_t count) noexcept {
+    if (count >= size()) {
+        return;
+    }
+    m_x.resize(count);
+    m_y.resize(count);
+    m_width.resize(count);
+    m_height.resize(count);
+    m_color.resize(count);
+    m_flags.resize(count);
+}
+
+void RectangleStore::compact() noexcept {
+    //     :      
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < size(); ++i) {
+        if (isRemoved(i)) {
+            continue;
+        }
+        if (kept != i) {
+            m_x[kept] = m_x[i];
+            m_y[kept] = m_y[i];
+            m_width[kept] = m_width[i];
+            m_height[kept] = m_height[i];
+            m_color[kept] = m_color[i];
+            m_flags[kept] = m_flags[i];
+        }
+        ++kept;
+    }
+    truncate(kept);
+}
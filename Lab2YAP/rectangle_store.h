@@ -0,0 +1,111 @@
+#pragma once
+
+#include "rectangle.h"
+#include <vector>
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+//   " ": x, y, ,   
+//     ,   -  Color.
+//               .
+//       Rectangle ( ).
+//      std::pmr::memory_resource (,   ..).
+class RectangleStore {
+public:
+    //   
+    static const std::uint8_t kNotOverlap = 1;
+    //    (Screen::removeRectangle)  ;    
+    static const std::uint8_t kRemoved = 2;
+
+    //   range-for  :  Rectangle  
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Rectangle;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        // const-:   "for (auto& r : ...)" ,   const std::vector
+        using reference = const Rectangle;
+
+        const_iterator(const RectangleStore* store, std::size_t index) noexcept
+            : m_store(store), m_index(index) {}
+
+        const Rectangle operator*() const { return (*m_store)[m_index]; }
+        const_iterator& operator++() noexcept { ++m_index; return *this; }
+        const_iterator operator++(int) noexcept { const_iterator old = *this; ++m_index; return old; }
+        bool operator==(const const_iterator& other) const noexcept { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const noexcept { return m_index != other.m_index; }
+
+    private:
+        const RectangleStore* m_store;
+        std::size_t m_index;
+    };
+
+    explicit RectangleStore(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept
+        : m_x(resource), m_y(resource), m_width(resource), m_height(resource),
+        m_color(resource), m_flags(resource) {}
+
+    std::pmr::memory_resource* resource() const noexcept { return m_x.get_allocator().resource(); }
+
+    std::size_t size() const noexcept { return m_x.size(); }
+    //    :   reserve   
+    std::size_t capacity() const noexcept;
+    bool empty() const noexcept { return m_x.empty(); }
+
+    //  Rectangle   (,     )
+    Rectangle operator[](std::size_t index) const;
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+    //        (   - size())
+    const double* xs() const noexcept { return m_x.data(); }
+    const double* ys() const noexcept { return m_y.data(); }
+    const double* widths() const noexcept { return m_width.data(); }
+    const double* heights() const noexcept { return m_height.data(); }
+    const Color* colors() const noexcept { return m_color.data(); }
+    const std::uint8_t* flags() const noexcept { return m_flags.data(); }
+
+    double getX(std::size_t index) const noexcept { return m_x[index]; }
+    double getY(std::size_t index) const noexcept { return m_y[index]; }
+    double getWidth(std::size_t index) const noexcept { return m_width[index]; }
+    double getHeight(std::size_t index) const noexcept { return m_height[index]; }
+    Color getColor(std::size_t index) const noexcept { return m_color[index]; }
+    bool getNotOverlap(std::size_t index) const noexcept { return (m_flags[index] & kNotOverlap) != 0; }
+    bool isRemoved(std::size_t index) const noexcept { return (m_flags[index] & kRemoved) != 0; }
+
+    void setColor(std::size_t index, Color color) noexcept { m_color[index] = color; }
+    //       (   );     
+    void setBounds(std::size_t index, double x, double y, double w, double h) noexcept {
+        m_x[index] = x;
+        m_y[index] = y;
+        m_width[index] = w;
+        m_height[index] = h;
+    }
+    void markRemoved(std::size_t index) noexcept { m_flags[index] |= kRemoved; }
+
+    // ;     .
+    //  :  std::bad_alloc   .
+    void push_back(double x, double y, double w, double h, Color color, bool notOverlap);
+    void push_back(const Rectangle& rect);
+    void append(const RectangleStore& other); //    
+    //     count  (,   )
+    void appendColumns(const double* x, const double* y, const double* w, const double* h,
+        const Color* colors, const std::uint8_t* flags, std::size_t count);
+
+    void reserve(std::size_t count);
+    void truncate(std::size_t count) noexcept; //   count 
+    void clear() noexcept { truncate(0); }
+    //   kRemoved,   ;   
+    void compact() noexcept;
+
+private:
+    std::pmr::vector<double> m_x;
+    std::pmr::vector<double> m_y;
+    std::pmr::vector<double> m_width;
+    std::pmr::vector<double> m_height;
+    std::pmr::vector<Color> m_color;
+    std::pmr::vector<std::uint8_t> m_flags;
+};
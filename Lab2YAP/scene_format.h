@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//     (Screen::saveBinary / Screen::loadBinary).
+//   -    ,   (  kByteOrderMark).
+//
+//   Header                          64 
+//                            paletteSize    kColorNameSize  ( )
+//     blockRecords    (   ):
+//       double x[n], y[n], w[n], h[n]
+//       uint8  color[n]                
+//       uint8  flags[n]             RectangleStore::kNotOverlap
+//          8  
+//
+//     8,   double    .
+namespace scene_format {
+    const char kMagic[8] = { 'L', '2', 'Y', 'S', 'C', 'E', 'N', 'E' };
+    const std::uint32_t kVersion = 1;
+    const std::uint32_t kByteOrderMark = 0x01020304;
+    const std::size_t kColorNameSize = 16;
+    const std::uint32_t kBlockRecords = 65536;
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        double width;        //  
+        double height;
+        std::uint64_t count; //  
+        std::uint32_t paletteSize;
+        std::uint32_t blockRecords;
+        std::uint8_t reserved[16];
+    };
+    static_assert(sizeof(Header) == 64, "Header must stay 64 bytes");
+
+    //    count   
+    inline std::uint64_t blockBytes(std::uint64_t count) noexcept {
+        return count * 4 * sizeof(double) + ((count * 2 + 7) & ~std::uint64_t(7));
+    }
+}
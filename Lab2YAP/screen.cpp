@@ -1,35 +1,365 @@
 #include "screen.h"
+#include "file_parser.h"
+#include "mapped_file.h"
+#include "svg_writer.h"
+#include "overlap_kernels.h"
+#include "scene_format.h"
 #include <fstream>   //  std::ofstream, std::ifstream
-#include <sstream>   //  std::stringstream ( )
+#include <algorithm> //  std::copy
 #include <iostream>  //  std::cerr
 #include <vector>    //     loadFromFile
 #include <limits>    //  numeric_limits
+#include <cstdint>   //  std::uint32_t
+#include <cstring>   //  std::memcpy, std::memcmp
+#include <filesystem> //  std::filesystem::file_size
+#include <future>    //  std::async  saveSVGAsync
 
-Screen::Screen(double width, double height) noexcept
+namespace {
+    //     loadFromFile
+    const size_t kReadBufferSize = 1 << 20;
+    //   findOverlapping     
+    const size_t kOverlapTile = 1024;
+    //   ,     kMinCompaction     :
+    //    ,       O(1)
+    const size_t kMinCompaction = 1024;
+
+    //    (     )
+    const char* const kOutOfBoundsError = "Rectangle is out of screen bounds.";
+    const char* const kOverlapError = "Rectangle with notOverlap=true overlaps with an existing rectangle.";
+}
+
+const char* placementErrorMessage(PlacementError error) noexcept {
+    switch (error) {
+    case PlacementError::None:
+        return "";
+    case PlacementError::NonPositiveSize:
+        return kNonPositiveSizeError;
+    case PlacementError::SizeTooLarge:
+        return kTooLargeSizeError;
+    case PlacementError::OutOfBounds:
+        return kOutOfBoundsError;
+    case PlacementError::Overlap:
+        return kOverlapError;
+    case PlacementError::OutOfMemory:
+        return "Memory allocation failed while adding rectangle.";
+    case PlacementError::NotFound:
+        return "No rectangle with this id on the screen.";
+    case PlacementError::NoSpace:
+        return "No free space for a rectangle of this size on the screen.";
+    case PlacementError::InvalidColor:
+        return kInvalidColorError;
+    }
+    return "Unknown placement error.";
+}
+
+size_t PlacementResult::value() const {
+    if (!has_value()) {
+        throw std::logic_error(std::string("PlacementResult has no value: ") + placementErrorMessage(m_error));
+    }
+    return m_index;
+}
+
+Screen::Screen(double width, double height, std::pmr::memory_resource* resource) noexcept
     : m_width(width > 0 ? width : 100.0), //    
     m_height(height > 0 ? height : 100.0),
-    m_lastError("") {}
+    m_rectangles(resource),
+    m_index(m_width, m_height),
+    m_idShift(0),
+    m_removedCount(0),
+    m_lastError(""),
+    m_revision(0),
+    m_freeSpaceValid(false),
+    m_freeSpaceSynced(0),
+    m_freeSpaceRevision(0) {}
+
+void Screen::clear() noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::Clear);
+    ++m_revision;
+    m_index.truncate(0);
+    m_rectangles.clear(); //     
+    m_idShift = 0;
+    m_removedCount = 0;
+}
 
 //    
 bool Screen::checkOverlap(const Rectangle& rect) const noexcept {
     if (rect.getNotOverlap()) { //     
-        for (const auto& existingRect : m_rectangles) {
-            if (rect.overlaps(existingRect)) {
-                return true; //  
+        m_stats.add(ScreenStatsCollector::OverlapTests);
+        //         
+        return m_index.anyOverlap(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight());
+    }
+    return false; //   (   )
+}
+
+//      
+void Screen::commitRectangle(const Rectangle& rect) {
+    commitRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(),
+        rect.getColorId(), rect.getNotOverlap());
+}
+
+void Screen::commitRectangle(double x, double y, double w, double h, Color color, bool notOverlap) {
+    m_rectangles.push_back(x, y, w, h, color, notOverlap);
+    try {
+        m_index.insert(nextId() - 1, x, y, w, h);
+    }
+    catch (...) {
+        m_rectangles.truncate(m_rectangles.size() - 1); //      
+        throw;
+    }
+}
+
+bool Screen::isInsideScreen(const Rectangle& rect) const noexcept {
+    return isInsideScreen(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight());
+}
+
+bool Screen::isInsideScreen(double x, double y, double w, double h) const noexcept {
+    return !(x < 0 || y < 0 || x + w > m_width || y + h > m_height);
+}
+
+PlacementResult Screen::checkPlacement(double x, double y, double w, double h, bool notOverlap) const noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::CheckPlacement);
+    //     Rectangle  addRectangle: , , 
+    if (const char* error = Rectangle::dimensionsError(w, h)) {
+        m_stats.add(ScreenStatsCollector::RejectedSize);
+        return PlacementResult::failure(error == kNonPositiveSizeError ?
+            PlacementError::NonPositiveSize : PlacementError::SizeTooLarge);
+    }
+    if (!isInsideScreen(x, y, w, h)) {
+        m_stats.add(ScreenStatsCollector::RejectedBounds);
+        return PlacementResult::failure(PlacementError::OutOfBounds);
+    }
+    if (notOverlap) {
+        m_stats.add(ScreenStatsCollector::OverlapTests);
+        std::size_t conflict = m_index.findOverlap(x, y, w, h);
+        if (conflict != SpatialGrid::kNoId) {
+            m_stats.add(ScreenStatsCollector::RejectedOverlap);
+            return PlacementResult::failure(PlacementError::Overlap, conflict);
+        }
+    }
+    return PlacementResult::success(nextId());
+}
+
+PlacementResult Screen::insertRectangle(double x, double y, double w, double h, Color color, bool notOverlap) noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::InsertRectangle);
+    if (!Rectangle::isValidColor(color)) {
+        return PlacementResult::failure(PlacementError::InvalidColor);
+    }
+    PlacementResult result = checkPlacement(x, y, w, h, notOverlap);
+    if (result) {
+        try {
+            commitRectangle(x, y, w, h, color, notOverlap);
+        }
+        catch (...) {
+            return PlacementResult::failure(PlacementError::OutOfMemory);
+        }
+    }
+    return result;
+}
+
+PlacementResult Screen::insertRectangle(const Rectangle& rect) noexcept {
+    return insertRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(),
+        rect.getColorId(), rect.getNotOverlap());
+}
+
+// ---    ---
+bool Screen::contains(size_t id) const noexcept {
+    return m_index.position(id) != SpatialGrid::kNoId;
+}
+
+Rectangle Screen::getRectangle(size_t id) const {
+    size_t slot = m_index.position(id);
+    if (slot == SpatialGrid::kNoId) {
+        throw std::out_of_range(placementErrorMessage(PlacementError::NotFound));
+    }
+    return m_rectangles[slot];
+}
+
+bool Screen::removeRectangle(size_t id) noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::RemoveRectangle);
+    //          :       
+    size_t slot = m_index.position(id);
+    if (slot == SpatialGrid::kNoId) {
+        return false;
+    }
+    m_index.remove(id);
+    m_rectangles.markRemoved(slot);
+    ++m_removedCount;
+    ++m_revision;
+    compactIfSparse();
+    return true;
+}
+
+PlacementResult Screen::moveRectangle(size_t id, double x, double y) noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::MoveRectangle);
+    size_t slot = m_index.position(id);
+    if (slot == SpatialGrid::kNoId) {
+        return PlacementResult::failure(PlacementError::NotFound);
+    }
+    return updateRectangle(id, x, y, m_rectangles.getWidth(slot), m_rectangles.getHeight(slot));
+}
+
+PlacementResult Screen::resizeRectangle(size_t id, double w, double h) noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::ResizeRectangle);
+    size_t slot = m_index.position(id);
+    if (slot == SpatialGrid::kNoId) {
+        return PlacementResult::failure(PlacementError::NotFound);
+    }
+    return updateRectangle(id, m_rectangles.getX(slot), m_rectangles.getY(slot), w, h);
+}
+
+PlacementResult Screen::updateRectangle(size_t id, double x, double y, double w, double h) noexcept {
+    size_t slot = m_index.position(id);
+    if (const char* error = Rectangle::dimensionsError(w, h)) {
+        m_stats.add(ScreenStatsCollector::RejectedSize);
+        return PlacementResult::failure(error == kNonPositiveSizeError ?
+            PlacementError::NonPositiveSize : PlacementError::SizeTooLarge);
+    }
+    if (!isInsideScreen(x, y, w, h)) {
+        m_stats.add(ScreenStatsCollector::RejectedBounds);
+        return PlacementResult::failure(PlacementError::OutOfBounds);
+    }
+
+    try {
+        //  -      ,   :
+        //     
+        std::vector<size_t> neighbours;
+        m_stats.add(ScreenStatsCollector::OverlapTests);
+        m_index.collectOverlaps(x, y, w, h, neighbours);
+        bool notOverlap = m_rectangles.getNotOverlap(slot);
+        for (size_t other : neighbours) {
+            if (other == id) {
+                continue; //    
+            }
+            //     :       
+            bool conflict = other < id ? notOverlap : m_rectangles.getNotOverlap(m_index.position(other));
+            if (conflict) {
+                m_stats.add(ScreenStatsCollector::RejectedOverlap);
+                return PlacementResult::failure(PlacementError::Overlap, other);
             }
         }
+        m_index.update(id, x, y, w, h);
     }
-    return false; //   (   )
+    catch (...) {
+        return PlacementResult::failure(PlacementError::OutOfMemory);
+    }
+    m_rectangles.setBounds(slot, x, y, w, h);
+    ++m_revision;
+    return PlacementResult::success(id);
+}
+
+// ---   ---
+void Screen::syncFreeSpace() {
+    if (!m_freeSpaceValid || m_freeSpaceRevision != m_revision || m_freeSpaceSynced > m_rectangles.size()) {
+        //     ,  MaxRects   : 
+        m_freeSpaceValid = false;
+        m_freeSpace.reset(m_width, m_height);
+        m_freeSpaceSynced = 0;
+        m_freeSpaceRevision = m_revision;
+    }
+    //     ( )
+    for (size_t slot = m_freeSpaceSynced; slot < m_rectangles.size(); ++slot) {
+        if (!m_rectangles.isRemoved(slot)) {
+            m_freeSpace.occupy(m_rectangles.getX(slot), m_rectangles.getY(slot),
+                m_rectangles.getWidth(slot), m_rectangles.getHeight(slot));
+        }
+    }
+    m_freeSpaceSynced = m_rectangles.size();
+    m_freeSpaceValid = true;
+}
+
+PlacementResult Screen::placeInFreeSpace(double w, double h, Color color, PlacementStrategy strategy) {
+    syncFreeSpace();
+    double x = 0;
+    double y = 0;
+    while (m_freeSpace.find(w, h, strategy, x, y)) {
+        //   :      
+        m_stats.add(ScreenStatsCollector::OverlapTests);
+        bool valid = isInsideScreen(x, y, w, h) && !m_index.anyOverlap(x, y, w, h);
+        //   :     ,   
+        m_freeSpaceValid = false;
+        m_freeSpace.occupy(x, y, w, h);
+        if (valid) {
+            commitRectangle(x, y, w, h, color, true);
+            m_freeSpaceSynced = m_rectangles.size();
+            m_freeSpaceValid = true;
+            return PlacementResult::success(nextId() - 1);
+        }
+        //     (  -   ,   ),
+        //    ,      
+        m_freeSpaceValid = true;
+    }
+    return PlacementResult::failure(PlacementError::NoSpace);
+}
+
+PlacementResult Screen::placeRectangle(double w, double h, Color color, PlacementStrategy strategy) noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::PlaceRectangle);
+    if (const char* error = Rectangle::dimensionsError(w, h)) {
+        m_stats.add(ScreenStatsCollector::RejectedSize);
+        return PlacementResult::failure(error == kNonPositiveSizeError ?
+            PlacementError::NonPositiveSize : PlacementError::SizeTooLarge);
+    }
+    if (!Rectangle::isValidColor(color)) {
+        return PlacementResult::failure(PlacementError::InvalidColor);
+    }
+    try {
+        return placeInFreeSpace(w, h, color, strategy);
+    }
+    catch (...) {
+        m_freeSpaceValid = false; //     
+        return PlacementResult::failure(PlacementError::OutOfMemory);
+    }
+}
+
+std::vector<PlacementResult> Screen::placeRectangles(std::span<const RectangleSize> sizes,
+    PlacementStrategy strategy, bool sortBySize)
+{
+    ScopedOperationTimer timer(m_stats, ScreenOp::PlaceRectangles);
+    std::vector<PlacementResult> results(sizes.size(), PlacementResult::failure(PlacementError::OutOfMemory));
+    std::vector<size_t> order(sizes.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    if (sortBySize) {
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            double longA = std::max(sizes[a].width, sizes[a].height);
+            double longB = std::max(sizes[b].width, sizes[b].height);
+            if (longA != longB) {
+                return longA > longB;
+            }
+            return std::min(sizes[a].width, sizes[a].height) > std::min(sizes[b].width, sizes[b].height);
+        });
+    }
+    for (size_t i : order) {
+        results[i] = placeRectangle(sizes[i].width, sizes[i].height, sizes[i].color, strategy);
+    }
+    return results;
+}
+
+void Screen::compactIfSparse() noexcept {
+    if (m_removedCount >= kMinCompaction && m_removedCount * 4 >= m_rectangles.size()) {
+        compact();
+    }
+}
+
+void Screen::compact() noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::Compact);
+    if (m_removedCount == 0) {
+        return;
+    }
+    //   ,   ,      
+    m_rectangles.compact();
+    m_index.compact();
+    m_idShift += m_removedCount;
+    m_removedCount = 0;
+    ++m_revision; //    ,  SVG    
 }
 
 //    
 bool Screen::checkRectanglePlacement(const Rectangle& rect, bool throwOnError) {
     // 6.     
-    if (rect.getX() < 0 || rect.getY() < 0 ||
-        rect.getX() + rect.getWidth() > m_width ||
-        rect.getY() + rect.getHeight() > m_height)
-    {
-        m_lastError = "Rectangle is out of screen bounds.";
+    if (!isInsideScreen(rect)) {
+        m_stats.add(ScreenStatsCollector::RejectedBounds);
+        m_lastError = kOutOfBoundsError;
         if (throwOnError) {
             throw ScreenError(m_lastError, rect); //  ScreenError
         }
@@ -38,7 +368,8 @@ bool Screen::checkRectanglePlacement(const Rectangle& rect, bool throwOnError) {
 
     // 7.  
     if (checkOverlap(rect)) {
-        m_lastError = "Rectangle with notOverlap=true overlaps with an existing rectangle.";
+        m_stats.add(ScreenStatsCollector::RejectedOverlap);
+        m_lastError = kOverlapError;
         if (throwOnError) {
             throw ScreenError(m_lastError, rect); //  ScreenError
         }
@@ -51,27 +382,29 @@ bool Screen::checkRectanglePlacement(const Rectangle& rect, bool throwOnError) {
 
 
 void Screen::addRectangle(const Rectangle& rect) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::AddRectangle);
     //         
     checkRectanglePlacement(rect, true); // true -    
 
     //     (   ), 
-    // std::vector::push_back      
+    // commitRectangle      ,   
     // (   std::bad_alloc)
-    m_rectangles.push_back(rect);
+    commitRectangle(rect);
 }
 
 bool Screen::tryAddRectangle(const Rectangle& rect) noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::TryAddRectangle);
     // 8.  ,     (false)
     //     m_lastError  -  
     if (checkRectanglePlacement(rect, false)) {
         try {
             //      std::bad_alloc,    
-            m_rectangles.push_back(rect);
+            commitRectangle(rect);
             m_lastError = ""; //     
             return true;
         }
         catch (const std::bad_alloc&) {
-            m_lastError = "Memory allocation failed while adding rectangle.";
+            m_lastError = placementErrorMessage(PlacementError::OutOfMemory);
             //        
             return false;
         }
@@ -89,141 +422,694 @@ std::string Screen::getLastError() const noexcept {
     return m_lastError;
 }
 
-void Screen::saveSVG(const std::string& filename) const {
-    // 4.  std::ofstream   
-    std::ofstream outFile;
+void Screen::emplaceRectangle(double x, double y, double w, double h, std::string_view color, bool notOverlap) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::EmplaceRectangle);
+    //      Rectangle:  ,  
+    Rectangle::validateDimensions(w, h);
+    emplaceRectangle(x, y, w, h, Rectangle::colorFromName(color), notOverlap);
+}
+
+void Screen::emplaceRectangle(double x, double y, double w, double h, Color color, bool notOverlap) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::EmplaceRectangle);
+    Rectangle::validateDimensions(w, h);
+    Rectangle::validateColor(color);
+    PlacementResult result = checkPlacement(x, y, w, h, notOverlap);
+    if (!result) {
+        m_lastError = placementErrorMessage(result.error());
+        // Rectangle     ,   
+        throw ScreenError(m_lastError, Rectangle(x, y, w, h, color, notOverlap));
+    }
+    commitRectangle(x, y, w, h, color, notOverlap);
+    m_lastError = "";
+}
+
+bool Screen::tryEmplaceRectangle(double x, double y, double w, double h, Color color, bool notOverlap) noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::TryEmplaceRectangle);
+    PlacementResult result = insertRectangle(x, y, w, h, color, notOverlap);
+    m_lastError = result ? "" : placementErrorMessage(result.error());
+    return result.has_value();
+}
 
-    //      outFile  
-    outFile.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+void Screen::reserveFor(size_t extra) {
+    size_t needed = m_rectangles.size() + extra;
+    if (needed > m_rectangles.capacity()) {
+        //   :         
+        m_rectangles.reserve(std::max(needed, m_rectangles.size() * 2));
+    }
+}
+
+void Screen::addRectangles(std::span<const Rectangle> rects) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::AddRectangles);
+    size_t oldCount = m_rectangles.size();
+    reserveFor(rects.size()); //   std::bad_alloc,    
 
     try {
-        outFile.open(filename); //   ,      /
+        for (const Rectangle& rect : rects) {
+            //      ,       
+            const char* error = nullptr;
+            if (!isInsideScreen(rect)) {
+                m_stats.add(ScreenStatsCollector::RejectedBounds);
+                error = kOutOfBoundsError;
+            }
+            else if (checkOverlap(rect)) {
+                m_stats.add(ScreenStatsCollector::RejectedOverlap);
+                error = kOverlapError;
+            }
+            if (error != nullptr) {
+                m_lastError = error;
+                throw ScreenError(m_lastError, rect);
+            }
+            commitRectangle(rect); //  ,    
+        }
+    }
+    catch (...) {
+        //   :     
+        m_index.truncate(oldCount + m_idShift);
+        m_rectangles.truncate(oldCount);
+        throw;
+    }
+    m_lastError = "";
+}
+
+BatchStatus Screen::tryAddRectangles(std::span<const Rectangle> rects) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::TryAddRectangles);
+    BatchStatus status(rects.size()); // ,    
+    size_t oldCount = m_rectangles.size();
+
+    try {
+        reserveFor(rects.size());
+        for (size_t i = 0; i < rects.size(); ++i) {
+            const Rectangle& rect = rects[i];
+            if (!isInsideScreen(rect)) {
+                m_stats.add(ScreenStatsCollector::RejectedBounds);
+                BatchStatus::setBit(status.m_outOfBounds, i);
+                continue;
+            }
+            if (checkOverlap(rect)) {
+                m_stats.add(ScreenStatsCollector::RejectedOverlap);
+                BatchStatus::setBit(status.m_overlap, i);
+                continue;
+            }
+            commitRectangle(rect);
+            BatchStatus::setBit(status.m_added, i);
+            ++status.m_addedCount;
+        }
+    }
+    catch (...) {
+        //    :       m_lastError
+        m_index.truncate(oldCount + m_idShift);
+        m_rectangles.truncate(oldCount);
+        status.clear();
+        m_lastError = "Memory allocation failed while adding rectangles.";
+    }
+    return status;
+}
+
+std::vector<size_t> Screen::findOverlapping(const Rectangle& candidate) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::FindOverlapping);
+    OverlapQuery query{ candidate.getX(), candidate.getY(),
+        candidate.getX() + candidate.getWidth(), candidate.getY() + candidate.getHeight() };
+
+    //    :      
+    std::vector<size_t> result;
+    std::uint32_t found[kOverlapTile];
+    for (size_t first = 0; first < m_rectangles.size(); first += kOverlapTile) {
+        size_t count = std::min(kOverlapTile, m_rectangles.size() - first);
+        size_t hits = collectOverlaps(m_rectangles.xs() + first, m_rectangles.ys() + first,
+            m_rectangles.widths() + first, m_rectangles.heights() + first, count, query, found);
+        for (size_t i = 0; i < hits; ++i) {
+            size_t slot = first + found[i];
+            if (!m_rectangles.isRemoved(slot)) {
+                result.push_back(m_index.idAt(slot));
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<size_t> Screen::queryRegion(double x, double y, double w, double h) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::QueryRegion);
+    std::vector<size_t> result;
+    queryRegion(x, y, w, h, result);
+    return result;
+}
+
+void Screen::queryRegion(double x, double y, double w, double h, std::vector<size_t>& out) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::QueryRegion);
+    m_index.collectOverlaps(x, y, w, h, out);
+}
+
+size_t Screen::hitTest(double px, double py) const noexcept {
+    ScopedOperationTimer timer(m_stats, ScreenOp::HitTest);
+    size_t id = m_index.topmostAt(px, py);
+    return id == SpatialGrid::kNoId ? npos : id;
+}
+
+std::vector<size_t> Screen::hitTestAll(double px, double py) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::HitTestAll);
+    std::vector<size_t> result;
+    m_index.collectAt(px, py, result);
+    return result;
+}
+
+std::vector<size_t> Screen::kNearest(double px, double py, size_t k) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::KNearest);
+    std::vector<size_t> result;
+    m_index.nearest(px, py, std::min(k, size()), result);
+    return result;
+}
+
+std::vector<bool> Screen::overlapsAny(const std::vector<Rectangle>& candidates) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::OverlapsAny);
+    m_stats.add(ScreenStatsCollector::OverlapTests, candidates.size());
+    std::vector<bool> result(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const Rectangle& rect = candidates[i];
+        result[i] = m_index.anyOverlap(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight());
+    }
+    return result;
+}
+
+namespace {
+    //      first (   Rectangle::drawSVG)
+    void writeRectangles(SvgWriter& writer, const RectangleStore& rectangles, size_t first) {
+        for (size_t i = first; i < rectangles.size(); ++i) {
+            if (rectangles.isRemoved(i)) {
+                continue;
+            }
+            writer.writeRectangle(rectangles.getX(i), rectangles.getY(i),
+                rectangles.getWidth(i), rectangles.getHeight(i),
+                Rectangle::colorName(rectangles.getColor(i)));
+        }
+    }
+
+    //  ;   saveSVG  saveSVGAsync.   
+    std::uint64_t writeSVGFile(const std::string& filename, double width, double height, const RectangleStore& rectangles) {
+        // 4.   SvgWriter:     std::to_chars  operator<<
+        //   .  ,   ,    std::ios_base::failure.
+        try {
+            SvgWriter writer(filename); //   ,      /
+
+            //  SVG  
+            writer.writeHeader(width, height);
 
-        //  SVG
-        outFile << "<svg width=\"" << m_width << "\" height=\"" << m_height << "\" xmlns=\"http://www.w3.org/2000/svg\">\n";
-        outFile << "  <rect width=\"100%\" height=\"100%\" fill=\"lightgrey\" />\n"; // 
+            //   
+            writeRectangles(writer, rectangles, 0);
 
-        //   
-        for (const auto& rect : m_rectangles) {
-            rect.drawSVG(outFile); //  drawSVG    
-            //      - .exceptions()
+            //  SVG
+            writer.writeFooter();
+            writer.flush(); //        
+            return writer.bytesWritten();
         }
+        catch (const std::ios_base::failure& e) {
+            //        
+            //   runtime_error, ..    Rectangle
+            throw std::runtime_error("Error saving to SVG file '" + filename + "': " + e.what());
+        }
+        //   (, std::bad_alloc)  
+    }
+}
+
+void Screen::saveSVG(const std::string& filename) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::SaveSVG);
+    m_stats.add(ScreenStatsCollector::SvgBytesWritten, writeSVGFile(filename, m_width, m_height, m_rectangles));
+}
 
-        //  SVG
-        outFile << "</svg>\n";
+std::future<void> Screen::saveSVGAsync(const std::string& filename) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::SaveSVGAsync);
+    //  -    ( );      .
+    //    :      ,  writeSVGFile    
+    RectangleStore snapshot(m_rectangles);
+    return std::async(std::launch::async,
+        [filename, width = m_width, height = m_height, snapshot = std::move(snapshot)]() {
+            writeSVGFile(filename, width, height, snapshot);
+        });
+}
+
+SvgExportSummary Screen::saveSVGOptimized(const std::string& filename, const SvgExportOptions& options) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::SaveSVGOptimized);
+    try {
+        SvgWriter writer(filename);
+        writer.writeHeader(m_width, m_height);
+        SvgExportSummary summary = writeOptimizedRectangles(writer, m_rectangles, m_index, m_width, m_height, options);
+        writer.writeFooter();
+        writer.flush();
+        summary.bytes = writer.bytesWritten();
+        m_stats.add(ScreenStatsCollector::SvgBytesWritten, summary.bytes);
+        return summary;
+    }
+    catch (const std::ios_base::failure& e) {
+        throw std::runtime_error("Error saving to SVG file '" + filename + "': " + e.what());
+    }
+}
 
-        // outFile       try (RAII)
-        //    exceptions(),     outFile.fail()   
+bool Screen::saveSVGIncremental(const std::string& filename) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::SaveSVGIncremental);
+    SvgExportState& state = m_svgExport;
+    std::error_code ec;
+    std::uintmax_t fileBytes = std::filesystem::file_size(filename, ec);
+    //  ,    -  ,      
+    bool append = state.valid && state.filename == filename && state.revision == m_revision &&
+        state.flushedCount <= m_rectangles.size() && !ec && fileBytes == state.fileBytes;
+    if (append && state.flushedCount == m_rectangles.size()) {
+        return false; //   ,   
+    }
 
+    //   ,    :     
+    state.valid = false;
+    try {
+        // ,  ,   ,   
+        auto writeTail = [&](SvgWriter& writer, size_t first) {
+            writeRectangles(writer, m_rectangles, first);
+            state.trailerOffset = writer.position();
+            writer.writeFooter();
+            writer.flush();
+            m_stats.add(ScreenStatsCollector::SvgBytesWritten, writer.bytesWritten());
+        };
+        if (append) {
+            SvgWriter writer(filename, state.trailerOffset);
+            writeTail(writer, state.flushedCount);
+        }
+        else {
+            SvgWriter writer(filename);
+            writer.writeHeader(m_width, m_height);
+            writeTail(writer, 0);
+        }
     }
     catch (const std::ios_base::failure& e) {
-        //        
-        //   runtime_error, ..    Rectangle
         throw std::runtime_error("Error saving to SVG file '" + filename + "': " + e.what());
     }
-    //   (, std::bad_alloc)  
+
+    //     :       
+    fileBytes = std::filesystem::file_size(filename, ec);
+    if (!ec) {
+        state.filename = filename;
+        state.revision = m_revision;
+        state.flushedCount = m_rectangles.size();
+        state.fileBytes = fileBytes;
+        state.valid = true;
+    }
+    return !append;
 }
 
 
 // ---  2:    ---
-void Screen::loadFromFile(const std::string& filename) {
-    std::ifstream inFile;
-    //      ,    ..
-    inFile.exceptions(std::ifstream::failbit | std::ifstream::badbit); //   eofbit, ..    
+namespace {
+    //       ,     
+    // ( std::getline  std::stringstream   )
+    void readBuffered(const std::string& filename, RectangleFileParser& parser) {
+        std::ifstream inFile(filename, std::ios::in | std::ios::binary);
+        if (!inFile.is_open()) {
+            throw FileParseError(filename, 0, "File read error: unable to open file.");
+        }
 
-    std::vector<Rectangle> loadedRectangles; //     
-    int lineNumber = 0;
-    std::string currentLine;
-    std::string lastValidColor = ""; //    
+        parseStream(inFile, parser, kReadBufferSize);
+    }
 
+    //          ,
+    //   ifstream     
+    void readMapped(const std::string& filename, RectangleFileParser& parser) {
+        MappedFile file(filename); //  std::ios_base::failure  
+        const char* dataEnd = file.data() + file.size();
+        const char* tail = parser.parseLines(file.data(), dataEnd);
+        parser.parseLastLine(tail, dataEnd);
+    }
+}
+
+void Screen::reserveForFile(std::uintmax_t fileBytes) noexcept {
     try {
-        inFile.open(filename); //   
+        reserveFor(static_cast<size_t>(fileBytes / kTypicalLineBytes) + 1);
+    }
+    catch (const std::bad_alloc&) {
+        //    -      
+    }
+}
 
-        while (std::getline(inFile, currentLine)) {
-            lineNumber++;
-            std::stringstream ss(currentLine);
-            double cx, cy, w, h;
-            std::string colorStr = ""; //    
+void Screen::loadFromFile(const std::string& filename, LoadMode mode) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::LoadFromFile);
+    //       m_rectangles,   
+    //   .   :   ,
+    //   oldCount, .
+    size_t oldCount = m_rectangles.size();
+    RectangleFileParser parser(filename, m_rectangles);
+    std::uintmax_t fileBytes = 0;
 
-            //   4  
-            if (!(ss >> cx >> cy >> w >> h)) {
-                //    ( )
-                throw FileParseError(filename, lineNumber, "Invalid format - expected 'cx cy w h [color]'");
+    try {
+        try {
+            //      - ,       
+            std::error_code sizeError;
+            fileBytes = std::filesystem::file_size(filename, sizeError);
+            if (!sizeError) {
+                reserveForFile(fileBytes);
+            }
+            else {
+                fileBytes = 0;
             }
 
-            //    
-            if (ss >> colorStr) {
-                lastValidColor = colorStr; //    
+            if (mode == LoadMode::Parallel) {
+                //          
+                MappedFile file(filename); //  std::ios_base::failure  
+                if (!parseRectanglesParallel(filename, file.data(), file.size(), m_width, m_height, m_rectangles)) {
+                    throw FileParseError(filename, -1, "Rectangle loaded from file is out of screen bounds.");
+                }
+            }
+            else if (mode == LoadMode::Mapped) {
+                readMapped(filename, parser);
             }
             else {
-                //    ,   
-                colorStr = lastValidColor;
+                readBuffered(filename, parser);
             }
 
-            // ,       
-            std::string remaining;
-            if (ss >> remaining) {
-                throw FileParseError(filename, lineNumber, "Extra data found on line after expected fields.");
+            // ---     () ---
+            //       
+            // (  Parallel     ;   ,    )
+            if (mode != LoadMode::Parallel) {
+                for (size_t i = oldCount; i < m_rectangles.size(); ++i) {
+                    if (m_rectangles.getX(i) < 0 || m_rectangles.getY(i) < 0 ||
+                        m_rectangles.getX(i) + m_rectangles.getWidth(i) > m_width ||
+                        m_rectangles.getY(i) + m_rectangles.getHeight(i) > m_height)
+                    {
+                        //   ScreenError,      
+                        throw FileParseError(filename, -1, "Rectangle loaded from file is out of screen bounds."); // -1 ..      
+                    }
+                }
             }
+        }
+        catch (...) {
+            m_rectangles.truncate(oldCount); //  -   
+            throw;
+        }
 
-            // ---     (   ) ---
-             //    -  (cx, cy),      (x, y)
-            double x = cx - w / 2.0;
-            double y = cy - h / 2.0;
-
-            //      
-            //  Rectangle     
-            loadedRectangles.emplace_back(x, y, w, h, colorStr, false); //   notOverlap=false  
+        // ---    :      ---
+        // (   ;   indexLoaded     )
+        indexLoaded(oldCount, filename);
+        //    -  
+        countParsed(fileBytes, m_rectangles.size() - oldCount, timer.elapsedNs());
+    }
+    catch (const std::ios_base::failure& e) {
+        //      ( Mapped)
+        throw FileParseError(filename, parser.getLineNumber(), "File read error: " + std::string(e.what()));
+    }
+    catch (const std::invalid_argument& e) {
+        //    Rectangle (, )
+        throw FileParseError(filename, parser.getLineNumber(), "Invalid rectangle data: " + std::string(e.what()));
+    }
+    catch (const std::out_of_range& e) {
+        //    Rectangle ( > 1000)
+        throw FileParseError(filename, parser.getLineNumber(), "Invalid rectangle data: " + std::string(e.what()));
+    }
+    catch (const FileParseError& e) {
+        //     
+        throw;
+    }
+    catch (const std::exception& e) {
+        //     (, bad_alloc    )
+        throw FileParseError(filename, parser.getLineNumber(), "An unexpected error occurred during loading: " + std::string(e.what()));
+    }
+    //      try  m_rectangles    ,
+    //    .
+}
 
-        } //  while getline
+void Screen::indexLoaded(size_t oldCount, const std::string& filename) {
+    //   notOverlap=1     ,    ,
+    //       -     .
+    //      ,     -  O(N).
+    //          .
+    try {
+        size_t i = oldCount;
+        while (i < m_rectangles.size()) {
+            size_t runEnd = i;
+            while (runEnd < m_rectangles.size() && !m_rectangles.getNotOverlap(runEnd)) {
+                ++runEnd;
+            }
+            if (runEnd > i) {
+                m_index.insertBatch(i + m_idShift, m_rectangles.xs() + i, m_rectangles.ys() + i,
+                    m_rectangles.widths() + i, m_rectangles.heights() + i, runEnd - i);
+                i = runEnd;
+                continue;
+            }
 
-        // ---     (  ) ---
-        //            
-        for (const auto& newRect : loadedRectangles) {
-            //          
-            if (newRect.getX() < 0 || newRect.getY() < 0 ||
-                newRect.getX() + newRect.getWidth() > m_width ||
-                newRect.getY() + newRect.getHeight() > m_height)
+            m_stats.add(ScreenStatsCollector::OverlapTests);
+            if (m_index.anyOverlap(m_rectangles.getX(i), m_rectangles.getY(i),
+                m_rectangles.getWidth(i), m_rectangles.getHeight(i)))
             {
-                //   ScreenError,      
-                throw FileParseError(filename, -1, "Rectangle loaded from file is out of screen bounds."); // -1 ..      
+                //   ()  -   ,     
+                throw FileParseError(filename, static_cast<int>(i - oldCount) + 1, kOverlapError);
             }
-            // :           .
-            //   ,      newRect    loadedRectangles.
+            m_index.insert(i + m_idShift, m_rectangles.getX(i), m_rectangles.getY(i),
+                m_rectangles.getWidth(i), m_rectangles.getHeight(i));
+            ++i;
         }
+    }
+    catch (...) {
+        //      -   
+        m_index.truncate(oldCount + m_idShift);
+        m_rectangles.truncate(oldCount);
+        throw;
+    }
+}
 
 
-        // ---  :       ---
-        //         
-        m_rectangles.insert(m_rectangles.end(), loadedRectangles.begin(), loadedRectangles.end());
+// ---   ---
+namespace {
+    void writeSceneFile(const std::string& filename, double width, double height,
+        const RectangleStore& rectangles)
+    {
+        try {
+            std::ofstream file;
+            file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+            file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+            scene_format::Header header = {};
+            std::memcpy(header.magic, scene_format::kMagic, sizeof(header.magic));
+            header.version = scene_format::kVersion;
+            header.byteOrder = scene_format::kByteOrderMark;
+            header.width = width;
+            header.height = height;
+            header.count = rectangles.size();
+            header.paletteSize = static_cast<std::uint32_t>(kColorCount);
+            header.blockRecords = scene_format::kBlockRecords;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
+            // :        Color
+            char palette[kColorCount][scene_format::kColorNameSize] = {};
+            for (size_t i = 0; i < kColorCount; ++i) {
+                std::string_view name = Rectangle::colorName(static_cast<Color>(i));
+                std::memcpy(palette[i], name.data(), std::min(name.size(), scene_format::kColorNameSize - 1));
+            }
+            file.write(palette[0], sizeof(palette));
 
+            // :     ,    
+            const char padding[8] = {};
+            for (size_t first = 0; first < rectangles.size(); first += scene_format::kBlockRecords) {
+                size_t count = std::min<size_t>(scene_format::kBlockRecords, rectangles.size() - first);
+                std::streamsize columnBytes = static_cast<std::streamsize>(count * sizeof(double));
+                file.write(reinterpret_cast<const char*>(rectangles.xs() + first), columnBytes);
+                file.write(reinterpret_cast<const char*>(rectangles.ys() + first), columnBytes);
+                file.write(reinterpret_cast<const char*>(rectangles.widths() + first), columnBytes);
+                file.write(reinterpret_cast<const char*>(rectangles.heights() + first), columnBytes);
+                file.write(reinterpret_cast<const char*>(rectangles.colors() + first), static_cast<std::streamsize>(count));
+                file.write(reinterpret_cast<const char*>(rectangles.flags() + first), static_cast<std::streamsize>(count));
+                file.write(padding, static_cast<std::streamsize>((8 - count * 2 % 8) % 8));
+            }
+            file.close(); //        
+        }
+        catch (const std::ios_base::failure& e) {
+            throw std::runtime_error("Error saving to binary file '" + filename + "': " + e.what());
+        }
     }
-    catch (const std::ios_base::failure& e) {
-        //    (  ,    ..)
-        if (inFile.eof() && lineNumber == 0 && loadedRectangles.empty()) {
-            //   -    ,    
+}
+
+void Screen::saveBinary(const std::string& filename) const {
+    ScopedOperationTimer timer(m_stats, ScreenOp::SaveBinary);
+    if (m_removedCount == 0) {
+        writeSceneFile(filename, m_width, m_height, m_rectangles);
+        return;
+    }
+    //      :   
+    RectangleStore live(m_rectangles);
+    live.compact();
+    writeSceneFile(filename, m_width, m_height, live);
+}
+
+namespace {
+    //    ,    
+    scene_format::Header readSceneHeader(const MappedFile& file, const std::string& filename) {
+        scene_format::Header header;
+        if (file.size() < sizeof(header)) {
+            throw FileParseError(filename, 0, "Binary scene file is too short.");
         }
-        else {
-            throw FileParseError(filename, lineNumber, "File read error: " + std::string(e.what()));
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, scene_format::kMagic, sizeof(header.magic)) != 0) {
+            throw FileParseError(filename, 0, "Not a binary scene file.");
         }
+        if (header.version != scene_format::kVersion) {
+            throw FileParseError(filename, 0, "Unsupported binary scene version " + std::to_string(header.version) + ".");
+        }
+        if (header.byteOrder != scene_format::kByteOrderMark) {
+            throw FileParseError(filename, 0, "Binary scene file was written with a different byte order.");
+        }
+        if (header.paletteSize > 256 || header.blockRecords == 0 || header.blockRecords > (1u << 24)) {
+            throw FileParseError(filename, 0, "Corrupted binary scene header.");
+        }
+        return header;
     }
-    catch (const std::invalid_argument& e) {
-        //    Rectangle (, )
-        throw FileParseError(filename, lineNumber, "Invalid rectangle data: " + std::string(e.what()));
+
+    //        (   ).
+    //   ,    :    validateDimensions,  .
+    bool blockIsValid(const double* x, const double* y, const double* w, const double* h,
+        const std::uint8_t* colors, const std::uint8_t* flags, size_t count,
+        std::uint32_t paletteSize, double width, double height) noexcept
+    {
+        bool valid = true;
+        for (size_t i = 0; i < count; ++i) {
+            valid &= (w[i] > 0) & (w[i] <= 1000) & (h[i] > 0) & (h[i] <= 1000) &
+                (x[i] >= 0) & (y[i] >= 0) & (x[i] + w[i] <= width) & (y[i] + h[i] <= height) &
+                (colors[i] < paletteSize) & ((flags[i] & ~RectangleStore::kNotOverlap) == 0);
+        }
+        return valid;
     }
-    catch (const std::out_of_range& e) {
-        //    Rectangle ( > 1000)
-        throw FileParseError(filename, lineNumber, "Invalid rectangle data: " + std::string(e.what()));
+
+    //        ( ,   )
+    void throwRecordError(const double* x, const double* y, const double* w, const double* h,
+        const std::uint8_t* colors, const std::uint8_t* flags, size_t count, size_t firstRecord,
+        std::uint32_t paletteSize, double width, double height, const std::string& filename)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            int record = static_cast<int>(firstRecord + i) + 1;
+            try {
+                Rectangle::validateDimensions(w[i], h[i]);
+            }
+            catch (const std::exception& e) {
+                throw FileParseError(filename, record, "Invalid rectangle data: " + std::string(e.what()));
+            }
+            if (!(x[i] >= 0 && y[i] >= 0 && x[i] + w[i] <= width && y[i] + h[i] <= height)) {
+                throw FileParseError(filename, record, "Rectangle loaded from file is out of screen bounds.");
+            }
+            if (colors[i] >= paletteSize) {
+                throw FileParseError(filename, record, "Invalid color index in binary record.");
+            }
+            if ((flags[i] & ~RectangleStore::kNotOverlap) != 0) {
+                throw FileParseError(filename, record, "Invalid flags in binary record.");
+            }
+        }
     }
-    catch (const FileParseError& e) {
-        //     
+}
+
+void Screen::loadBinaryFrom(const MappedFile& file, const std::string& filename) {
+    scene_format::Header header = readSceneHeader(file, filename);
+    if (header.width != m_width || header.height != m_height) {
+        throw FileParseError(filename, 0, "Screen dimensions in binary scene file do not match the screen.");
+    }
+
+    //       (     )
+    const std::uint64_t fileSize = file.size();
+    std::uint64_t offset = sizeof(header) + std::uint64_t(header.paletteSize) * scene_format::kColorNameSize;
+    std::uint64_t fullBlocks = header.count / header.blockRecords;
+    std::uint64_t lastBlock = header.count % header.blockRecords;
+    if (header.count > fileSize / (4 * sizeof(double) + 2) ||
+        offset + fullBlocks * scene_format::blockBytes(header.blockRecords) + scene_format::blockBytes(lastBlock) != fileSize)
+    {
+        throw FileParseError(filename, 0, "Binary scene file size does not match its header.");
+    }
+
+    //   -> Color  
+    Color paletteColors[256];
+    const char* palette = file.data() + sizeof(header);
+    for (std::uint32_t i = 0; i < header.paletteSize; ++i) {
+        const char* name = palette + i * scene_format::kColorNameSize;
+        size_t length = 0;
+        while (length < scene_format::kColorNameSize && name[length] != '\0') {
+            ++length;
+        }
+        try {
+            paletteColors[i] = Rectangle::colorFromName(std::string_view(name, length));
+        }
+        catch (const std::invalid_argument& e) {
+            throw FileParseError(filename, 0, "Invalid binary scene palette: " + std::string(e.what()));
+        }
+    }
+
+    size_t count = static_cast<size_t>(header.count);
+    size_t oldCount = m_rectangles.size();
+    m_rectangles.reserve(oldCount + count); //     
+    std::vector<Color> colors(std::min<size_t>(count, header.blockRecords));
+    try {
+        for (size_t first = 0; first < count; first += header.blockRecords) {
+            size_t blockCount = std::min<size_t>(header.blockRecords, count - first);
+            //     8 ,    
+            const char* block = file.data() + offset;
+            const double* x = reinterpret_cast<const double*>(block);
+            const double* y = x + blockCount;
+            const double* w = y + blockCount;
+            const double* h = w + blockCount;
+            const std::uint8_t* colorIndices = reinterpret_cast<const std::uint8_t*>(h + blockCount);
+            const std::uint8_t* flags = colorIndices + blockCount;
+
+            if (!blockIsValid(x, y, w, h, colorIndices, flags, blockCount, header.paletteSize, m_width, m_height)) {
+                throwRecordError(x, y, w, h, colorIndices, flags, blockCount, first,
+                    header.paletteSize, m_width, m_height, filename);
+            }
+            for (size_t i = 0; i < blockCount; ++i) {
+                colors[i] = paletteColors[colorIndices[i]];
+            }
+            m_rectangles.appendColumns(x, y, w, h, colors.data(), flags, blockCount);
+            offset += scene_format::blockBytes(blockCount);
+        }
+    }
+    catch (...) {
+        m_rectangles.truncate(oldCount);
+        throw;
+    }
+
+    indexLoaded(oldCount, filename);
+}
+
+void Screen::countParsed(std::uintmax_t bytes, size_t lines, std::uint64_t nanoseconds) noexcept {
+    m_stats.add(ScreenStatsCollector::BytesParsed, bytes);
+    m_stats.add(ScreenStatsCollector::LinesParsed, lines);
+    m_stats.add(ScreenStatsCollector::ParseNs, nanoseconds);
+}
+
+void Screen::loadBinary(const std::string& filename) {
+    ScopedOperationTimer timer(m_stats, ScreenOp::LoadBinary);
+    try {
+        MappedFile file(filename); //  std::ios_base::failure  
+        size_t oldCount = m_rectangles.size();
+        loadBinaryFrom(file, filename);
+        countParsed(file.size(), m_rectangles.size() - oldCount, timer.elapsedNs());
+    }
+    catch (const std::ios_base::failure& e) {
+        throw FileParseError(filename, 0, "File read error: " + std::string(e.what()));
+    }
+    catch (const FileParseError&) {
         throw;
     }
     catch (const std::exception& e) {
-        //     (, bad_alloc    )
-        throw FileParseError(filename, lineNumber, "An unexpected error occurred during loading: " + std::string(e.what()));
+        throw FileParseError(filename, 0, "An unexpected error occurred during loading: " + std::string(e.what()));
+    }
+}
+
+Screen Screen::fromBinary(const std::string& filename) {
+    try {
+        MappedFile file(filename);
+        scene_format::Header header = readSceneHeader(file, filename);
+        Screen screen(header.width, header.height);
+        {
+            //  -   ,      
+            ScopedOperationTimer timer(screen.m_stats, ScreenOp::LoadBinary);
+            screen.loadBinaryFrom(file, filename);
+            screen.countParsed(file.size(), screen.m_rectangles.size(), timer.elapsedNs());
+        }
+        return screen;
+    }
+    catch (const std::ios_base::failure& e) {
+        throw FileParseError(filename, 0, "File read error: " + std::string(e.what()));
+    }
+    catch (const FileParseError&) {
+        throw;
+    }
+    catch (const std::exception& e) {
+        throw FileParseError(filename, 0, "An unexpected error occurred during loading: " + std::string(e.what()));
     }
-    //      try,  m_rectangles   ,
-    //        loadedRectangles.
 }
@@ -1,10 +1,19 @@
 #pragma once
 
 #include "rectangle.h"
+#include "rectangle_store.h"
+#include "spatial_grid.h"
+#include "screen_stats.h"
+#include "free_space.h"
+#include "svg_optimizer.h"
 #include <vector>
 #include <string>
+#include <span>
+#include <algorithm> //  std::fill
+#include <cstdint>
 #include <stdexcept> //  std::runtime_error
 #include <fstream>   //    
+#include <future>    //  saveSVGAsync
 
 // 5.    ScreenError
 class ScreenError : public std::runtime_error {
@@ -25,10 +34,121 @@ private:
     Rectangle m_rectangle; //   
 };
 
+class MappedFile;
+
+//     Screen::loadFromFile
+enum class LoadMode {
+    Buffered, //    std::ifstream
+    Mapped,   //    
+    Parallel  //         
+};
+
+//     :   ,  - placementErrorMessage
+enum class PlacementError : std::uint8_t {
+    None = 0,
+    NonPositiveSize, //    <= 0
+    SizeTooLarge,    //     1000
+    OutOfBounds,     //    
+    Overlap,         // notOverlap      
+    OutOfMemory,
+    NotFound,        //      (moveRectangle, resizeRectangle)
+    NoSpace,         // placeRectangle:       
+    InvalidColor     //  Color  
+};
+
+//     ( ,   ,     getLastError)
+const char* placementErrorMessage(PlacementError error) noexcept;
+
+//  Screen::insertRectangle   std::expected<size_t, PlacementError>:
+//     (Screen::removeRectangle  ..)   .   .
+class PlacementResult {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    static PlacementResult success(size_t index) noexcept { return PlacementResult(PlacementError::None, index); }
+    // conflictIndex -    , -   ( Overlap)
+    static PlacementResult failure(PlacementError error, size_t conflictIndex = npos) noexcept {
+        return PlacementResult(error, conflictIndex);
+    }
+
+    bool has_value() const noexcept { return m_error == PlacementError::None; }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    //   ;    std::logic_error ( bad_expected_access)
+    size_t value() const;
+    size_t value_or(size_t fallback) const noexcept { return has_value() ? m_index : fallback; }
+
+    PlacementError error() const noexcept { return m_error; }
+    //  Overlap -    ,  npos
+    size_t conflictIndex() const noexcept { return has_value() ? npos : m_index; }
+    //     
+    std::string message() const { return placementErrorMessage(m_error); }
+
+private:
+    PlacementResult(PlacementError error, size_t index) noexcept : m_error(error), m_index(index) {}
+
+    PlacementError m_error;
+    size_t m_index;
+};
+
+//    (Screen::tryAddRectangles):      .
+//      ;     -
+//     -   (. getLastError).
+class BatchStatus {
+public:
+    explicit BatchStatus(size_t count)
+        : m_size(count), m_addedCount(0),
+        m_added(wordCount(count)), m_outOfBounds(wordCount(count)), m_overlap(wordCount(count)) {}
+
+    size_t size() const noexcept { return m_size; }
+    size_t addedCount() const noexcept { return m_addedCount; }
+    bool allAdded() const noexcept { return m_addedCount == m_size; }
+
+    bool added(size_t index) const noexcept { return testBit(m_added, index); }
+    bool outOfBounds(size_t index) const noexcept { return testBit(m_outOfBounds, index); }
+    bool overlaps(size_t index) const noexcept { return testBit(m_overlap, index); }
+
+    //    ( i -   i / 64),     popcount
+    const std::vector<std::uint64_t>& addedBits() const noexcept { return m_added; }
+
+private:
+    friend class Screen;
+
+    static size_t wordCount(size_t count) noexcept { return (count + 63) / 64; }
+    static bool testBit(const std::vector<std::uint64_t>& bits, size_t index) noexcept {
+        return (bits[index / 64] >> (index % 64)) & 1u;
+    }
+    static void setBit(std::vector<std::uint64_t>& bits, size_t index) noexcept {
+        bits[index / 64] |= std::uint64_t(1) << (index % 64);
+    }
+    void clear() noexcept {
+        m_addedCount = 0;
+        std::fill(m_added.begin(), m_added.end(), 0);
+        std::fill(m_outOfBounds.begin(), m_outOfBounds.end(), 0);
+        std::fill(m_overlap.begin(), m_overlap.end(), 0);
+    }
+
+    size_t m_size;
+    size_t m_addedCount;
+    std::vector<std::uint64_t> m_added;
+    std::vector<std::uint64_t> m_outOfBounds;
+    std::vector<std::uint64_t> m_overlap;
+};
+
+//        (Screen::placeRectangles)
+struct RectangleSize {
+    double width;
+    double height;
+    Color color = Color::None;
+};
+
 //  ""
 class Screen {
 public:
-    Screen(double width, double height) noexcept; //    
+    //    .
+    // resource -      (,     )
+    Screen(double width, double height,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
 
     //   ( )
     void addRectangle(const Rectangle& rect);
@@ -37,31 +157,219 @@ public:
     bool tryAddRectangle(const Rectangle& rect) noexcept; //  noexcept
     std::string getLastError() const noexcept; //    
 
+    //      ,  Rectangle  .
+    //     ,    Rectangle  addRectangle
+    void emplaceRectangle(double x, double y, double w, double h, std::string_view color = {}, bool notOverlap = false);
+    void emplaceRectangle(double x, double y, double w, double h, Color color, bool notOverlap = false);
+    // ˸       :  ,   ,
+    //    -   m_lastError      
+    bool tryEmplaceRectangle(double x, double y, double w, double h,
+        Color color = Color::None, bool notOverlap = false) noexcept;
+
+    //   -:  ,      
+    // (m_lastError  ).     .
+    PlacementResult insertRectangle(double x, double y, double w, double h,
+        Color color = Color::None, bool notOverlap = false) noexcept;
+    PlacementResult insertRectangle(const Rectangle& rect) noexcept;
+    //  ;   value() - ,    
+    PlacementResult checkPlacement(double x, double y, double w, double h, bool notOverlap) const noexcept;
+
+    //  :       ,     ,
+    //        (      ).
+    // addRectangles -   :     ScreenError,   .
+    void addRectangles(std::span<const Rectangle> rects);
+    // tryAddRectangles    ,  ; m_lastError  
+    // (   -    ).    std::bad_alloc
+    //    BatchStatus,  - .
+    BatchStatus tryAddRectangles(std::span<const Rectangle> rects);
+
+    //  :     notOverlap    
+    //  (free_space.h)      tryAddRectangle. 
+    //    ,    .    
+    //     ,   clear (    -
+    // O(N *  )).   (, NoSpace, OutOfMemory)   
+    PlacementResult placeRectangle(double w, double h, Color color = Color::None,
+        PlacementStrategy strategy = PlacementStrategy::BestFit) noexcept;
+    //  :  sortBySize   ( ,    ),
+    //   .  -   sizes;     .
+    //    std::bad_alloc   ,  - 
+    std::vector<PlacementResult> placeRectangles(std::span<const RectangleSize> sizes,
+        PlacementStrategy strategy = PlacementStrategy::BestFit, bool sortBySize = true);
+
+    //     SIMD- (overlap_kernels.h);  notOverlap   
+    //     ,   candidate (   )
+    std::vector<size_t> findOverlapping(const Rectangle& candidate) const;
+    //   :          ( )
+    std::vector<bool> overlapsAny(const std::vector<Rectangle>& candidates) const;
+
+    //   ,       Rectangle:  - 
+    // .   out    (    ).
+    static const size_t npos = static_cast<size_t>(-1);
+    // ,    ( Rectangle::overlaps),   
+    std::vector<size_t> queryRegion(double x, double y, double w, double h) const;
+    void queryRegion(double x, double y, double w, double h, std::vector<size_t>& out) const;
+    //  ( )     npos.
+    //  ,  x <= px < x + w  y <= py < y + h (  )
+    size_t hitTest(double px, double py) const noexcept;
+    //    ,   
+    std::vector<size_t> hitTestAll(double px, double py) const;
+    // k        (0,   );
+    //   ,   -  
+    std::vector<size_t> kNearest(double px, double py, size_t k) const;
+
     // 4.   SVG    
     void saveSVG(const std::string& filename) const;
+    //           .    
+    //    (    ),     ,
+    //     "</svg>";    .
+    //     ,    saveSVG.  -   saveSVG.
+    //  true,     .
+    bool saveSVGIncremental(const std::string& filename);
+    //    .   (  ) 
+    //  ,     ,   .  
+    // (std::runtime_error,   saveSVG)  future::get(); std::system_error -
+    //     .   : future  std::async
+    //     ,       .
+    std::future<void> saveSVGAsync(const std::string& filename) const;
+    //     SVG (. writeOptimizedRectangles):  
+    //  ,    <path>.  quantum   ,   saveSVG.
+    //  -   saveSVG
+    SvgExportSummary saveSVGOptimized(const std::string& filename, const SvgExportOptions& options = {}) const;
+
+    //     .     (value() 
+    // PlacementResult),       ,    ;
+    //      ( clear).   -  ,
+    //    .
+    //  -         ;   
+    // ,     (  O(1)  ).
+    // false,      
+    bool removeRectangle(size_t id) noexcept;
+    //       insertRectangle,     
+    //   :   notOverlap      ( 
+    // ),     notOverlap - .       
+    // .   (   NotFound)   .
+    PlacementResult moveRectangle(size_t id, double x, double y) noexcept;
+    PlacementResult resizeRectangle(size_t id, double w, double h) noexcept;
+    bool contains(size_t id) const noexcept;
+    //  ; std::out_of_range,    
+    Rectangle getRectangle(size_t id) const;
+    //     ( )
+    size_t size() const noexcept { return m_rectangles.size() - m_removedCount; }
+    //  :     (,   getRectangles)
+    void compact() noexcept;
+
+    //   ,    :  
+    //      .     0
+    void clear() noexcept;
 
     //  2:   
-    void loadFromFile(const std::string& filename);
+    // Mapped -     (mmap)    .
+    //       (    ),
+    //     -   .
+    void loadFromFile(const std::string& filename, LoadMode mode = LoadMode::Buffered);
+
+    //   (scene_format.h):  ,     .
+    //   -         .
+    //   - std::runtime_error,   saveSVG
+    void saveBinary(const std::string& filename) const;
+    //     ,   loadFromFile;      
+    //   .  FileParseError    -   ( 1), 0 - .
+    void loadBinary(const std::string& filename);
+    //      
+    static Screen fromBinary(const std::string& filename);
 
     //  (  )
     double getWidth() const noexcept { return m_width; }
     double getHeight() const noexcept { return m_height; }
-    const std::vector<Rectangle>& getRectangles() const noexcept { return m_rectangles; }
+    //      Rectangle ( )    .
+    //     ;    ,      .
+    //  removeRectangle        isRemoved()
+    const RectangleStore& getRectangles() const noexcept { return m_rectangles; }
+
+    //  (screen_stats.h):    ,     SVG,
+    //    .   (LAB2YAP_NO_STATS) - 
+    ScreenStats stats() const noexcept { return m_stats.snapshot(); }
+    void resetStats() noexcept { m_stats.reset(); }
+    //   stats()  out (    period,    );
+    // nullptr - 
+    void setStatsDump(std::ostream* out, std::chrono::milliseconds period = std::chrono::seconds(1)) noexcept {
+        m_stats.setDump(out, period);
+    }
 
 private:
     double m_width;
     double m_height;
-    std::vector<Rectangle> m_rectangles;
-    std::string m_lastError; //  tryAddRectangle
+    RectangleStore m_rectangles; //    std::vector<Rectangle>
+    SpatialGrid m_index; //   m_rectangles (id -  )  checkOverlap
+    //  =    + m_idShift  ,    
+    size_t m_idShift;
+    size_t m_removedCount; //    ,  
+    //  tryAddRectangle:   ,   getLastError   
+    const char* m_lastError;
+    // ,        (clear  ..):
+    //    SVG- 
+    std::uint64_t m_revision;
+
+    //      saveSVGIncremental
+    struct SvgExportState {
+        bool valid = false;
+        std::string filename;
+        std::uint64_t revision = 0;  // m_revision   
+        size_t flushedCount = 0;     //      
+        std::streamoff trailerOffset = 0; //    "</svg>"
+        std::uintmax_t fileBytes = 0; //    
+    };
+    SvgExportState m_svgExport;
+    //    const- (, )
+    mutable ScreenStatsCollector m_stats;
+    //    placeRectangle:     m_freeSpaceSynced
+    //  m_revision == m_freeSpaceRevision
+    FreeSpaceMap m_freeSpace;
+    bool m_freeSpaceValid;
+    size_t m_freeSpaceSynced;
+    std::uint64_t m_freeSpaceRevision;
 
     //      
     //  true,   ,  false (  m_lastError)
     //   ,  throwOnError = true
     bool checkRectanglePlacement(const Rectangle& rect, bool throwOnError);
 
+    //      
+    bool isInsideScreen(const Rectangle& rect) const noexcept;
+    bool isInsideScreen(double x, double y, double w, double h) const noexcept;
+
+
+    //      extra   (    )
+    void reserveFor(size_t extra);
+    //           fileBytes;  ,
+    //     
+    void reserveForFile(std::uintmax_t fileBytes) noexcept;
+
     //     
     //  true,   ,  false
     bool checkOverlap(const Rectangle& rect) const noexcept;
+
+    // ,     
+    size_t nextId() const noexcept { return m_rectangles.size() + m_idShift; }
+    //   moveRectangle  resizeRectangle
+    PlacementResult updateRectangle(size_t id, double x, double y, double w, double h) noexcept;
+    void compactIfSparse() noexcept;
+    //  m_freeSpace     (   )
+    void syncFreeSpace();
+    // placeRectangle   
+    PlacementResult placeInFreeSpace(double w, double h, Color color, PlacementStrategy strategy);
+
+    //       ;     
+    void commitRectangle(const Rectangle& rect);
+    void commitRectangle(double x, double y, double w, double h, Color color, bool notOverlap);
+
+    //         oldCount,  notOverlap.
+    //     ,    oldCount (  - FileParseError)
+    void indexLoaded(size_t oldCount, const std::string& filename);
+
+    void loadBinaryFrom(const MappedFile& file, const std::string& filename);
+    //     
+    void countParsed(std::uintmax_t bytes, size_t lines, std::uint64_t nanoseconds) noexcept;
 };
 
 //       ( 2)
@@ -0,0 +1,200 @@
+#include "screen_stats.h"
+#include <algorithm> //  std::min
+#include <bit>       //  std::bit_width
+#include <cmath>     //  std::ceil
+#include <iomanip>   //  std::setw
+
+namespace {
+    const char* const kOperationNames[kScreenOpCount] = {
+        "addRectangle",
+        "tryAddRectangle",
+        "emplaceRectangle",
+        "tryEmplaceRectangle",
+        "insertRectangle",
+        "checkPlacement",
+        "removeRectangle",
+        "moveRectangle",
+        "resizeRectangle",
+        "queryRegion",
+        "hitTest",
+        "hitTestAll",
+        "kNearest",
+        "findOverlapping",
+        "placeRectangle",
+        "overlapsAny",
+        "addRectangles",
+        "tryAddRectangles",
+        "placeRectangles",
+        "compact",
+        "clear",
+        "loadFromFile",
+        "loadBinary",
+        "saveSVG",
+        "saveSVGIncremental",
+        "saveSVGAsync",
+        "saveSVGOptimized",
+        "saveBinary"
+    };
+
+    double perSecond(std::uint64_t amount, std::uint64_t nanoseconds) noexcept {
+        return nanoseconds > 0 ? static_cast<double>(amount) * 1e9 / static_cast<double>(nanoseconds) : 0.0;
+    }
+}
+
+const char* screenOpName(ScreenOp op) noexcept {
+    size_t index = static_cast<size_t>(op);
+    return index < kScreenOpCount ? kOperationNames[index] : "unknown";
+}
+
+double LatencyHistogram::meanNs() const noexcept {
+    return timed > 0 ? static_cast<double>(totalNs) / static_cast<double>(timed) : 0.0;
+}
+
+std::uint64_t LatencyHistogram::percentileNs(double p) const noexcept {
+    if (timed == 0) {
+        return 0;
+    }
+    //  ,    Lab2YAPBench
+    double rank = std::ceil(p / 100.0 * static_cast<double>(timed));
+    std::uint64_t target = rank < 1 ? 1 : static_cast<std::uint64_t>(rank);
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            //  i -   2^i;    
+            return i == 0 ? 0 : std::min(maxNs, (std::uint64_t(1) << i) - 1);
+        }
+    }
+    return maxNs;
+}
+
+double ScreenStats::linesPerSecond() const noexcept {
+    return perSecond(linesParsed, parseNs);
+}
+
+double ScreenStats::bytesPerSecond() const noexcept {
+    return perSecond(bytesParsed, parseNs);
+}
+
+void ScreenStats::print(std::ostream& out) const {
+    out << "overlap tests: " << overlapTests
+        << "; rejected: size " << rejectedSize << ", bounds " << rejectedBounds << ", overlap " << rejectedOverlap << "\n"
+        << "parsed: " << bytesParsed << " bytes, " << linesParsed << " lines in " << parseNs * 1e-9 << " s ("
+        << linesPerSecond() << " lines/s, " << bytesPerSecond() << " bytes/s)\n"
+        << "svg written: " << svgBytesWritten << " bytes\n";
+    for (size_t i = 0; i < kScreenOpCount; ++i) {
+        const LatencyHistogram& histogram = operations[i];
+        if (histogram.calls == 0) {
+            continue;
+        }
+        out << "  " << std::left << std::setw(20) << kOperationNames[i] << std::right
+            << " calls " << histogram.calls << ", timed " << histogram.timed
+            << ", mean " << histogram.meanNs() << " ns, p50 <= " << histogram.percentileNs(50)
+            << " ns, p99 <= " << histogram.percentileNs(99) << " ns, max " << histogram.maxNs << " ns\n";
+    }
+}
+
+#ifndef LAB2YAP_NO_STATS
+
+void ScreenStatsCollector::recordTime(ScreenOp op, std::uint64_t nanoseconds) noexcept {
+    OperationSlot& slot = m_operations[static_cast<size_t>(op)];
+    bump(slot.timed, 1);
+    bump(slot.totalNs, nanoseconds);
+    if (nanoseconds > slot.maxNs.load(std::memory_order_relaxed)) {
+        slot.maxNs.store(nanoseconds, std::memory_order_relaxed);
+    }
+    size_t bucket = std::min<size_t>(static_cast<size_t>(std::bit_width(nanoseconds)), LatencyHistogram::kBuckets - 1);
+    bump(slot.buckets[bucket], 1);
+}
+
+ScreenStats ScreenStatsCollector::snapshot() const noexcept {
+    ScreenStats stats;
+    auto read = [](const std::atomic<std::uint64_t>& value) { return value.load(std::memory_order_relaxed); };
+    stats.overlapTests = read(m_counters[OverlapTests]);
+    stats.rejectedSize = read(m_counters[RejectedSize]);
+    stats.rejectedBounds = read(m_counters[RejectedBounds]);
+    stats.rejectedOverlap = read(m_counters[RejectedOverlap]);
+    stats.bytesParsed = read(m_counters[BytesParsed]);
+    stats.linesParsed = read(m_counters[LinesParsed]);
+    stats.parseNs = read(m_counters[ParseNs]);
+    stats.svgBytesWritten = read(m_counters[SvgBytesWritten]);
+    for (size_t i = 0; i < kScreenOpCount; ++i) {
+        const OperationSlot& slot = m_operations[i];
+        LatencyHistogram& histogram = stats.operations[i];
+        histogram.calls = read(slot.calls);
+        histogram.timed = read(slot.timed);
+        histogram.totalNs = read(slot.totalNs);
+        histogram.maxNs = read(slot.maxNs);
+        for (size_t b = 0; b < LatencyHistogram::kBuckets; ++b) {
+            histogram.buckets[b] = read(slot.buckets[b]);
+        }
+    }
+    return stats;
+}
+
+void ScreenStatsCollector::reset() noexcept {
+    for (std::atomic<std::uint64_t>& counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (OperationSlot& slot : m_operations) {
+        slot.calls.store(0, std::memory_order_relaxed);
+        slot.timed.store(0, std::memory_order_relaxed);
+        slot.totalNs.store(0, std::memory_order_relaxed);
+        slot.maxNs.store(0, std::memory_order_relaxed);
+        for (std::atomic<std::uint64_t>& bucket : slot.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ScreenStatsCollector::copyFrom(const ScreenStatsCollector& other) noexcept {
+    for (size_t i = 0; i < CounterCount; ++i) {
+        m_counters[i].store(other.m_counters[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kScreenOpCount; ++i) {
+        const OperationSlot& from = other.m_operations[i];
+        OperationSlot& to = m_operations[i];
+        to.calls.store(from.calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.timed.store(from.timed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.totalNs.store(from.totalNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.maxNs.store(from.maxNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for (size_t b = 0; b < LatencyHistogram::kBuckets; ++b) {
+            to.buckets[b].store(from.buckets[b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+}
+
+void ScreenStatsCollector::setDump(std::ostream* out, std::chrono::milliseconds period) noexcept {
+    m_dumpPeriodNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(period).count(), std::memory_order_relaxed);
+    //   -  period  
+    m_nextDumpNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch() + period).count(), std::memory_order_relaxed);
+    m_dumpOut.store(out, std::memory_order_release);
+}
+
+void ScreenStatsCollector::dumpSlow(Clock::time_point now) noexcept {
+    std::int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    std::int64_t due = m_nextDumpNs.load(std::memory_order_relaxed);
+    if (nowNs < due) {
+        return;
+    }
+    //   ,  ,    
+    if (!m_nextDumpNs.compare_exchange_strong(due, nowNs + m_dumpPeriodNs.load(std::memory_order_relaxed),
+        std::memory_order_relaxed))
+    {
+        return;
+    }
+    std::ostream* out = m_dumpOut.load(std::memory_order_acquire);
+    if (out == nullptr) {
+        return;
+    }
+    try {
+        snapshot().print(*out);
+        out->flush();
+    }
+    catch (...) {
+        //        
+    }
+}
+
+#endif
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+//  Screen:        .
+//   LAB2YAP_NO_STATS    ( inline-  ),
+// Screen::stats()   .
+
+//   Screen,    .
+//   (tryEmplaceRectangle -> insertRectangle, removeRectangle -> compact)
+//    
+enum class ScreenOp : std::uint8_t {
+    //      :     kSampleEvery- 
+    AddRectangle,
+    TryAddRectangle,
+    EmplaceRectangle,
+    TryEmplaceRectangle,
+    InsertRectangle,
+    CheckPlacement,
+    RemoveRectangle,
+    MoveRectangle,
+    ResizeRectangle,
+    QueryRegion,
+    HitTest,
+    HitTestAll,
+    KNearest,
+    FindOverlapping,
+    PlaceRectangle,
+    //  -  ,   
+    OverlapsAny,
+    AddRectangles,
+    TryAddRectangles,
+    PlaceRectangles,
+    Compact,
+    Clear,
+    LoadFromFile,
+    LoadBinary,
+    SaveSVG,
+    SaveSVGIncremental,
+    SaveSVGAsync,
+    SaveSVGOptimized,
+    SaveBinary,
+    Count
+};
+
+const std::size_t kScreenOpCount = static_cast<std::size_t>(ScreenOp::Count);
+
+const char* screenOpName(ScreenOp op) noexcept;
+
+//    :  i -  [2^(i-1), 2^i) ,  0 - 0 
+struct LatencyHistogram {
+    static const std::size_t kBuckets = 40; //   -   2^38  (~4.6 )
+
+    std::uint64_t calls = 0;   //  
+    std::uint64_t timed = 0;   //   
+    std::uint64_t totalNs = 0; //  
+    std::uint64_t maxNs = 0;
+    std::array<std::uint64_t, kBuckets> buckets = {};
+
+    //   ; 0,   
+    double meanNs() const noexcept;
+    //   ,     p (0..100):  ,
+    //  -    ; 0,   
+    std::uint64_t percentileNs(double p) const noexcept;
+};
+
+//    (Screen::stats)
+struct ScreenStats {
+    //    :     
+    std::uint64_t overlapTests = 0;
+    //      (checkPlacement, checkRectanglePlacement,
+    // , moveRectangle/resizeRectangle)
+    std::uint64_t rejectedSize = 0;
+    std::uint64_t rejectedBounds = 0;
+    std::uint64_t rejectedOverlap = 0;
+    //  loadFromFile  loadBinary:  ,  ()   
+    std::uint64_t bytesParsed = 0;
+    std::uint64_t linesParsed = 0;
+    std::uint64_t parseNs = 0;
+    // saveSVG  saveSVGIncremental ( saveSVGAsync  :   
+    //  ,   )
+    std::uint64_t svgBytesWritten = 0;
+    std::array<LatencyHistogram, kScreenOpCount> operations = {};
+
+    const LatencyHistogram& operation(ScreenOp op) const noexcept {
+        return operations[static_cast<std::size_t>(op)];
+    }
+    double linesPerSecond() const noexcept;
+    double bytesPerSecond() const noexcept;
+
+    //  :        
+    void print(std::ostream& out) const;
+};
+
+#ifndef LAB2YAP_NO_STATS
+
+//    Screen.  - ,   
+// load + store   :  const-   
+//     ,     .
+class ScreenStatsCollector {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //     ,     
+    static const std::uint64_t kSampleEvery = 16;
+
+    enum Counter {
+        OverlapTests,
+        RejectedSize,
+        RejectedBounds,
+        RejectedOverlap,
+        BytesParsed,
+        LinesParsed,
+        ParseNs,
+        SvgBytesWritten,
+        CounterCount
+    };
+
+    ScreenStatsCollector() noexcept = default;
+    //      (   )
+    ScreenStatsCollector(const ScreenStatsCollector& other) noexcept { copyFrom(other); }
+    ScreenStatsCollector& operator=(const ScreenStatsCollector& other) noexcept {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    void add(Counter counter, std::uint64_t amount = 1) noexcept { bump(m_counters[counter], amount); }
+
+    //   : true,     
+    bool beginOperation(ScreenOp op) noexcept {
+        std::uint64_t calls = bump(m_operations[static_cast<std::size_t>(op)].calls, 1);
+        return op >= ScreenOp::OverlapsAny || (calls - 1) % kSampleEvery == 0; //   - 
+    }
+    void recordTime(ScreenOp op, std::uint64_t nanoseconds) noexcept;
+
+    ScreenStats snapshot() const noexcept;
+    void reset() noexcept;
+
+    //   snapshot().print  out     period;   
+    //  ,        .
+    // nullptr - .  out  ,   
+    void setDump(std::ostream* out, std::chrono::milliseconds period) noexcept;
+    void dumpIfDue(Clock::time_point now) noexcept {
+        if (m_dumpOut.load(std::memory_order_relaxed) != nullptr) {
+            dumpSlow(now);
+        }
+    }
+
+private:
+    struct OperationSlot {
+        std::atomic<std::uint64_t> calls{ 0 };
+        std::atomic<std::uint64_t> timed{ 0 };
+        std::atomic<std::uint64_t> totalNs{ 0 };
+        std::atomic<std::uint64_t> maxNs{ 0 };
+        std::array<std::atomic<std::uint64_t>, LatencyHistogram::kBuckets> buckets{};
+    };
+
+    std::array<std::atomic<std::uint64_t>, CounterCount> m_counters{};
+    std::array<OperationSlot, kScreenOpCount> m_operations;
+    std::atomic<std::ostream*> m_dumpOut{ nullptr };
+    std::atomic<std::int64_t> m_dumpPeriodNs{ 0 };
+    std::atomic<std::int64_t> m_nextDumpNs{ 0 }; //   Clock;  ,  
+
+    static std::uint64_t bump(std::atomic<std::uint64_t>& value, std::uint64_t amount) noexcept {
+        std::uint64_t result = value.load(std::memory_order_relaxed) + amount;
+        value.store(result, std::memory_order_relaxed);
+        return result;
+    }
+    void copyFrom(const ScreenStatsCollector& other) noexcept;
+    void dumpSlow(Clock::time_point now) noexcept;
+};
+
+//        .   - 
+//   ,    const-    
+class ScopedOperationTimer {
+public:
+    ScopedOperationTimer(ScreenStatsCollector& stats, ScreenOp op) noexcept
+        : m_stats(stats), m_op(op), m_timed(false)
+    {
+        if (t_depth++ == 0 && stats.beginOperation(op)) {
+            m_timed = true;
+            m_start = ScreenStatsCollector::Clock::now();
+        }
+    }
+    ~ScopedOperationTimer() {
+        --t_depth;
+        if (m_timed) {
+            ScreenStatsCollector::Clock::time_point now = ScreenStatsCollector::Clock::now();
+            m_stats.recordTime(m_op, static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count()));
+            m_stats.dumpIfDue(now);
+        }
+    }
+
+    ScopedOperationTimer(const ScopedOperationTimer&) = delete;
+    ScopedOperationTimer& operator=(const ScopedOperationTimer&) = delete;
+
+    //     (  ,  0)
+    std::uint64_t elapsedNs() const noexcept {
+        if (!m_timed) {
+            return 0;
+        }
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            ScreenStatsCollector::Clock::now() - m_start).count());
+    }
+
+private:
+    static inline thread_local int t_depth = 0;
+
+    ScreenStatsCollector& m_stats;
+    ScreenOp m_op;
+    bool m_timed;
+    ScreenStatsCollector::Clock::time_point m_start;
+};
+
+#else
+
+//  :   ,  
+class ScreenStatsCollector {
+public:
+    enum Counter {
+        OverlapTests,
+        RejectedSize,
+        RejectedBounds,
+        RejectedOverlap,
+        BytesParsed,
+        LinesParsed,
+        ParseNs,
+        SvgBytesWritten,
+        CounterCount
+    };
+
+    void add(Counter, std::uint64_t = 1) noexcept {}
+    ScreenStats snapshot() const noexcept { return ScreenStats(); }
+    void reset() noexcept {}
+    void setDump(std::ostream*, std::chrono::milliseconds) noexcept {}
+};
+
+class ScopedOperationTimer {
+public:
+    ScopedOperationTimer(ScreenStatsCollector&, ScreenOp) noexcept {}
+    std::uint64_t elapsedNs() const noexcept { return 0; }
+};
+
+#endif
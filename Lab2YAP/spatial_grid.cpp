@@ -0,0 +1,736 @@
+#include "spatial_grid.h"
+#include <cmath>     //  std::isnan
+#include <new>       //  std::bad_alloc
+#include <limits>    //     
+#include <algorithm> //  std::max, std::clamp, std::sort, std::push_heap, std::lower_bound, std::remove_if
+#include <utility>   //  std::pair
+
+namespace {
+    //     ,     
+    const std::size_t kInitialSide = 16;
+    const std::size_t kMaxSide = 512;
+    //        ,  
+    const std::size_t kCrowdedCell = 8;
+    //        ,  
+    const std::size_t kMaxAverageSpan = 4;
+    //      :       
+    const std::size_t kMinBatch = 256;
+    //          
+    const std::size_t kSizingSample = 16384;
+
+    //   [lo, hi]      [v0, v1].
+    //          .
+    //     : ,  
+    // ,     -  ,    .
+    //           
+    // std::floor (  ):        ,
+    //          ,     .
+    void axisRange(double v0, double v1, double inverseCellSize, std::size_t count,
+        std::size_t& lo, std::size_t& hi) noexcept
+    {
+        // NaN  :      Rectangle::overlaps   ,
+        //           
+        if (std::isnan(v0) || std::isnan(v1)) {
+            lo = 0;
+            hi = count - 1;
+            return;
+        }
+        auto toCell = [inverseCellSize, count](double value) -> std::size_t {
+            double cell = value * inverseCellSize;
+            if (!(cell > 0)) {
+                return 0;
+            }
+            if (cell >= static_cast<double>(count)) {
+                return count - 1;
+            }
+            return static_cast<std::size_t>(cell);
+        };
+        lo = toCell(v0);
+        hi = toCell(v1);
+    }
+
+    //      
+    void copyLane(OverlapBlock& to, std::size_t toLane, const OverlapBlock& from, std::size_t fromLane) noexcept {
+        to.x0[toLane] = from.x0[fromLane];
+        to.y0[toLane] = from.y0[fromLane];
+        to.x1[toLane] = from.x1[fromLane];
+        to.y1[toLane] = from.y1[fromLane];
+        to.id[toLane] = from.id[fromLane];
+    }
+
+    bool inRange(std::size_t c, std::size_t r, std::size_t c0, std::size_t r0, std::size_t c1, std::size_t r1) noexcept {
+        return c0 <= c && c <= c1 && r0 <= r && r <= r1;
+    }
+}
+
+void SpatialGrid::Cell::push_back(const Entry& entry) {
+    std::size_t slot = count;
+    if (slot % 4 == 0) {
+        //  ;    ,       
+        const double inf = std::numeric_limits<double>::infinity();
+        OverlapBlock block;
+        for (int lane = 0; lane < 4; ++lane) {
+            block.x0[lane] = inf;
+            block.y0[lane] = inf;
+            block.x1[lane] = -inf;
+            block.y1[lane] = -inf;
+            block.id[lane] = 0;
+        }
+        blocks.push_back(block); //  ,    
+    }
+    OverlapBlock& block = blocks[slot / 4];
+    std::size_t lane = slot % 4;
+    block.x0[lane] = entry.x0;
+    block.y0[lane] = entry.y0;
+    block.x1[lane] = entry.x1;
+    block.y1[lane] = entry.y1;
+    block.id[lane] = entry.id;
+    ++count;
+}
+
+void SpatialGrid::Cell::pop_back() noexcept {
+    std::size_t slot = --count;
+    if (slot % 4 == 0) {
+        blocks.pop_back();
+    }
+    else {
+        const double inf = std::numeric_limits<double>::infinity();
+        OverlapBlock& block = blocks[slot / 4];
+        std::size_t lane = slot % 4;
+        block.x0[lane] = inf;
+        block.y0[lane] = inf;
+        block.x1[lane] = -inf;
+        block.y1[lane] = -inf;
+    }
+}
+
+std::size_t SpatialGrid::Cell::find(std::size_t id) const noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (blocks[i / 4].id[i % 4] == id) {
+            return i;
+        }
+    }
+    return count;
+}
+
+void SpatialGrid::Cell::insertOrdered(const Entry& entry) {
+    push_back(entry); //  ,    
+    //   ,      id
+    std::size_t slot = count - 1;
+    while (slot > 0 && blocks[(slot - 1) / 4].id[(slot - 1) % 4] > entry.id) {
+        copyLane(blocks[slot / 4], slot % 4, blocks[(slot - 1) / 4], (slot - 1) % 4);
+        --slot;
+    }
+    OverlapBlock& block = blocks[slot / 4];
+    std::size_t lane = slot % 4;
+    block.x0[lane] = entry.x0;
+    block.y0[lane] = entry.y0;
+    block.x1[lane] = entry.x1;
+    block.y1[lane] = entry.y1;
+    block.id[lane] = entry.id;
+}
+
+void SpatialGrid::Cell::erase(std::size_t slot) noexcept {
+    for (std::size_t i = slot; i + 1 < count; ++i) {
+        copyLane(blocks[i / 4], i % 4, blocks[(i + 1) / 4], (i + 1) % 4);
+    }
+    pop_back(); //    
+}
+
+SpatialGrid::SpatialGrid(double width, double height)
+    : SpatialGrid(0.0, 0.0, width, height) {}
+
+SpatialGrid::SpatialGrid(double originX, double originY, double width, double height)
+    : m_originX(originX), m_originY(originY), m_width(width), m_height(height),
+    m_cols(0), m_rows(0), m_cellWidth(0), m_cellHeight(0), m_inverseCellWidth(0), m_inverseCellHeight(0),
+    m_entryCount(0)
+{
+    resize(kInitialSide, kInitialSide);
+}
+
+void SpatialGrid::cellRange(double x0, double y0, double x1, double y1,
+    std::size_t& c0, std::size_t& r0, std::size_t& c1, std::size_t& r1) const noexcept
+{
+    //         ;     
+    axisRange(x0 - m_originX, x1 - m_originX, m_inverseCellWidth, m_cols, c0, c1);
+    axisRange(y0 - m_originY, y1 - m_originY, m_inverseCellHeight, m_rows, r0, r1);
+}
+
+std::size_t SpatialGrid::firstColumn(double x0) const noexcept {
+    std::size_t lo, hi;
+    axisRange(x0 - m_originX, x0 - m_originX, m_inverseCellWidth, m_cols, lo, hi);
+    return lo;
+}
+
+std::size_t SpatialGrid::firstRow(double y0) const noexcept {
+    std::size_t lo, hi;
+    axisRange(y0 - m_originY, y0 - m_originY, m_inverseCellHeight, m_rows, lo, hi);
+    return lo;
+}
+
+std::size_t SpatialGrid::estimateEntries(std::size_t side) const noexcept {
+    double inverseCellWidth = static_cast<double>(side) / m_width;
+    double inverseCellHeight = static_cast<double>(side) / m_height;
+    //  :  step- 
+    std::size_t step = std::max<std::size_t>(1, m_bounds.size() / kSizingSample);
+    std::size_t entries = 0;
+    std::size_t sampled = 0;
+    for (std::size_t i = 0; i < m_bounds.size(); i += step) {
+        const Entry& entry = m_bounds[i];
+        if (entry.removed) {
+            continue;
+        }
+        std::size_t c0, r0, c1, r1;
+        axisRange(entry.x0 - m_originX, entry.x1 - m_originX, inverseCellWidth, side, c0, c1);
+        axisRange(entry.y0 - m_originY, entry.y1 - m_originY, inverseCellHeight, side, r0, r1);
+        entries += (r1 - r0 + 1) * (c1 - c0 + 1);
+        ++sampled;
+    }
+    return sampled == 0 ? 0 : entries / sampled * m_bounds.size() + entries % sampled * m_bounds.size() / sampled;
+}
+
+void SpatialGrid::placeEntry(const Entry& entry) {
+    std::size_t c0, r0, c1, r1;
+    cellRange(entry.x0, entry.y0, entry.x1, entry.y1, c0, r0, c1, r1);
+
+    std::size_t placed = 0;
+    try {
+        for (std::size_t r = r0; r <= r1; ++r) {
+            for (std::size_t c = c0; c <= c1; ++c) {
+                m_cells[r * m_cols + c].push_back(entry);
+                ++placed;
+            }
+        }
+    }
+    catch (...) {
+        //    :       
+        for (std::size_t r = r0; r <= r1 && placed > 0; ++r) {
+            for (std::size_t c = c0; c <= c1 && placed > 0; ++c) {
+                m_cells[r * m_cols + c].pop_back();
+                --placed;
+            }
+        }
+        throw;
+    }
+    m_entryCount += (r1 - r0 + 1) * (c1 - c0 + 1);
+}
+
+void SpatialGrid::insert(std::size_t id, double x, double y, double w, double h) {
+    Entry entry{ x, y, x + w, y + h, id };
+
+    m_bounds.push_back(entry); //  ,     
+    try {
+        placeEntry(entry);
+    }
+    catch (...) {
+        m_bounds.pop_back();
+        throw;
+    }
+
+    refineIfCrowded();
+}
+
+void SpatialGrid::placeRange(std::size_t first) {
+    //      (    kMaxSide,  16 )
+    struct Span {
+        std::uint16_t c0;
+        std::uint16_t r0;
+        std::uint16_t c1;
+        std::uint16_t r1;
+    };
+    std::size_t count = m_bounds.size() - first;
+    std::vector<Span> spans(count);
+
+    // 1.           
+    std::vector<std::uint32_t> added(m_cells.size(), 0);
+    std::vector<std::size_t> rowStart(m_rows + 1, 0);
+    std::size_t placed = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Entry& entry = m_bounds[first + i];
+        if (entry.removed) {
+            spans[i] = Span{ 0, 1, 0, 0 }; //   :   
+            continue;
+        }
+        std::size_t c0, r0, c1, r1;
+        cellRange(entry.x0, entry.y0, entry.x1, entry.y1, c0, r0, c1, r1);
+        spans[i] = Span{ static_cast<std::uint16_t>(c0), static_cast<std::uint16_t>(r0),
+            static_cast<std::uint16_t>(c1), static_cast<std::uint16_t>(r1) };
+        for (std::size_t r = r0; r <= r1; ++r) {
+            ++rowStart[r + 1];
+            for (std::size_t c = c0; c <= c1; ++c) {
+                ++added[r * m_cols + c];
+            }
+        }
+        placed += (r1 - r0 + 1) * (c1 - c0 + 1);
+    }
+
+    // 2.     ( ,   -   id).
+    //        ,      
+    for (std::size_t r = 0; r < m_rows; ++r) {
+        rowStart[r + 1] += rowStart[r];
+    }
+    std::vector<std::uint32_t> rowEntries(rowStart[m_rows]);
+    std::vector<std::size_t> rowFill(rowStart.begin(), rowStart.end() - 1);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t r = spans[i].r0; r <= spans[i].r1; ++r) {
+            rowEntries[rowFill[r]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    // 3.    ; reserve    ,  
+    for (std::size_t i = 0; i < m_cells.size(); ++i) {
+        if (added[i] != 0) {
+            Cell& cell = m_cells[i];
+            cell.blocks.reserve((cell.count + added[i] + 3) / 4);
+        }
+    }
+
+    // 4. ;   ,   .
+    //    id -    (   truncate)
+    for (std::size_t r = 0; r < m_rows; ++r) {
+        for (std::size_t k = rowStart[r]; k < rowStart[r + 1]; ++k) {
+            std::size_t i = rowEntries[k];
+            const Entry& entry = m_bounds[first + i];
+            for (std::size_t c = spans[i].c0; c <= spans[i].c1; ++c) {
+                m_cells[r * m_cols + c].push_back(entry);
+            }
+        }
+    }
+    m_entryCount += placed;
+}
+
+void SpatialGrid::insertBatch(std::size_t firstId, const double* x, const double* y, const double* w, const double* h,
+    std::size_t count)
+{
+    if (count < kMinBatch) {
+        try {
+            for (std::size_t i = 0; i < count; ++i) {
+                insert(firstId + i, x[i], y[i], w[i], h[i]);
+            }
+        }
+        catch (...) {
+            truncate(firstId);
+            throw;
+        }
+        return;
+    }
+
+    std::size_t oldSize = m_bounds.size();
+    m_bounds.reserve(oldSize + count); //  ,    
+    for (std::size_t i = 0; i < count; ++i) {
+        m_bounds.push_back(Entry{ x[i], y[i], x[i] + w[i], y[i] + h[i], firstId + i });
+    }
+    try {
+        // ,        ,  :
+        //     ,      
+        std::size_t side = m_cols;
+        while (side < kMaxSide && m_cols == m_rows) {
+            std::size_t entries = estimateEntries(side);
+            if (entries <= kCrowdedCell * side * side || entries >= kMaxAverageSpan * m_bounds.size()) {
+                break;
+            }
+            side *= 2;
+        }
+        if (side != m_cols) {
+            resize(side, side); //   ,  
+        }
+        else {
+            placeRange(oldSize);
+        }
+    }
+    catch (...) {
+        m_bounds.resize(oldSize);
+        throw;
+    }
+
+    refineIfCrowded();
+}
+
+void SpatialGrid::truncate(std::size_t firstId) noexcept {
+    if (firstId == 0) {
+        //  :   ,      
+        for (Cell& cell : m_cells) {
+            cell.blocks.clear();
+            cell.count = 0;
+        }
+        m_bounds.clear();
+        m_entryCount = 0;
+        return;
+    }
+    //     :     id   
+    while (!m_bounds.empty() && m_bounds.back().id >= firstId) {
+        const Entry& entry = m_bounds.back();
+        if (entry.removed) {
+            m_bounds.pop_back(); //    
+            continue;
+        }
+        std::size_t c0, r0, c1, r1;
+        cellRange(entry.x0, entry.y0, entry.x1, entry.y1, c0, r0, c1, r1);
+        for (std::size_t r = r0; r <= r1; ++r) {
+            for (std::size_t c = c0; c <= c1; ++c) {
+                m_cells[r * m_cols + c].pop_back();
+            }
+        }
+        m_entryCount -= (r1 - r0 + 1) * (c1 - c0 + 1);
+        m_bounds.pop_back();
+    }
+}
+
+std::size_t SpatialGrid::position(std::size_t id) const noexcept {
+    std::size_t slot;
+    if (id < m_bounds.size() && m_bounds[id].id == id) {
+        slot = id; //    ,    
+    }
+    else {
+        //   m_bounds ,      
+        auto it = std::lower_bound(m_bounds.begin(), m_bounds.end(), id,
+            [](const Entry& entry, std::size_t value) { return entry.id < value; });
+        if (it == m_bounds.end() || it->id != id) {
+            return kNoId;
+        }
+        slot = static_cast<std::size_t>(it - m_bounds.begin());
+    }
+    return m_bounds[slot].removed ? kNoId : slot;
+}
+
+bool SpatialGrid::remove(std::size_t id) noexcept {
+    std::size_t slot = position(id);
+    if (slot == kNoId) {
+        return false;
+    }
+    Entry& entry = m_bounds[slot];
+    std::size_t c0, r0, c1, r1;
+    cellRange(entry.x0, entry.y0, entry.x1, entry.y1, c0, r0, c1, r1);
+    for (std::size_t r = r0; r <= r1; ++r) {
+        for (std::size_t c = c0; c <= c1; ++c) {
+            Cell& cell = m_cells[r * m_cols + c];
+            cell.erase(cell.find(entry.id));
+        }
+    }
+    m_entryCount -= (r1 - r0 + 1) * (c1 - c0 + 1);
+    entry.removed = true;
+    return true;
+}
+
+void SpatialGrid::update(std::size_t id, double x, double y, double w, double h) {
+    Entry& entry = m_bounds[position(id)];
+    Entry moved{ x, y, x + w, y + h, entry.id };
+    std::size_t oc0, or0, oc1, or1;
+    cellRange(entry.x0, entry.y0, entry.x1, entry.y1, oc0, or0, oc1, or1);
+    std::size_t nc0, nr0, nc1, nr1;
+    cellRange(moved.x0, moved.y0, moved.x1, moved.y1, nc0, nr0, nc1, nr1);
+
+    // 1. ,    :    
+    std::size_t added = 0;
+    try {
+        for (std::size_t r = nr0; r <= nr1; ++r) {
+            for (std::size_t c = nc0; c <= nc1; ++c) {
+                if (!inRange(c, r, oc0, or0, oc1, or1)) {
+                    m_cells[r * m_cols + c].insertOrdered(moved);
+                    ++added;
+                }
+            }
+        }
+    }
+    catch (...) {
+        for (std::size_t r = nr0; r <= nr1 && added > 0; ++r) {
+            for (std::size_t c = nc0; c <= nc1 && added > 0; ++c) {
+                if (!inRange(c, r, oc0, or0, oc1, or1)) {
+                    Cell& cell = m_cells[r * m_cols + c];
+                    cell.erase(cell.find(moved.id));
+                    --added;
+                }
+            }
+        }
+        throw;
+    }
+
+    // 2.  :       ,   
+    for (std::size_t r = or0; r <= or1; ++r) {
+        for (std::size_t c = oc0; c <= oc1; ++c) {
+            Cell& cell = m_cells[r * m_cols + c];
+            std::size_t slot = cell.find(moved.id);
+            if (!inRange(c, r, nc0, nr0, nc1, nr1)) {
+                cell.erase(slot);
+                continue;
+            }
+            OverlapBlock& block = cell.blocks[slot / 4];
+            std::size_t lane = slot % 4;
+            block.x0[lane] = moved.x0;
+            block.y0[lane] = moved.y0;
+            block.x1[lane] = moved.x1;
+            block.y1[lane] = moved.y1;
+        }
+    }
+    m_entryCount = m_entryCount - (or1 - or0 + 1) * (oc1 - oc0 + 1) + (nr1 - nr0 + 1) * (nc1 - nc0 + 1);
+    entry = moved;
+
+    refineIfCrowded();
+}
+
+void SpatialGrid::compact() noexcept {
+    m_bounds.erase(std::remove_if(m_bounds.begin(), m_bounds.end(),
+        [](const Entry& entry) { return entry.removed; }), m_bounds.end());
+}
+
+bool SpatialGrid::anyOverlap(double x, double y, double w, double h) const noexcept {
+    //   ,    Rectangle::overlaps,      
+    OverlapQuery query{ x, y, x + w, y + h };
+
+    std::size_t c0, r0, c1, r1;
+    cellRange(query.x0, query.y0, query.x1, query.y1, c0, r0, c1, r1);
+
+    for (std::size_t r = r0; r <= r1; ++r) {
+        for (std::size_t c = c0; c <= c1; ++c) {
+            const Cell& cell = m_cells[r * m_cols + c];
+            //   :  4  (AVX)   2 (SSE2)  
+            if (anyOverlapInBlocks(cell.blocks.data(), cell.count, query)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::size_t SpatialGrid::findOverlap(double x, double y, double w, double h) const noexcept {
+    OverlapQuery query{ x, y, x + w, y + h };
+
+    std::size_t c0, r0, c1, r1;
+    cellRange(query.x0, query.y0, query.x1, query.y1, c0, r0, c1, r1);
+
+    //      id,      -   ;
+    //     SIMD-,      
+    std::size_t result = kNoId;
+    for (std::size_t r = r0; r <= r1; ++r) {
+        for (std::size_t c = c0; c <= c1; ++c) {
+            const Cell& cell = m_cells[r * m_cols + c];
+            if (!anyOverlapInBlocks(cell.blocks.data(), cell.count, query)) {
+                continue;
+            }
+            std::size_t i = firstOverlapInBlocks(cell.blocks.data(), cell.count, query);
+            std::size_t id = cell.blocks[i / 4].id[i % 4];
+            result = std::min(result, id);
+        }
+    }
+    return result;
+}
+
+void SpatialGrid::collectOverlaps(double x, double y, double w, double h, std::vector<std::size_t>& out) const {
+    OverlapQuery query{ x, y, x + w, y + h };
+
+    std::size_t c0, r0, c1, r1;
+    cellRange(query.x0, query.y0, query.x1, query.y1, c0, r0, c1, r1);
+    bool singleCell = (c0 == c1 && r0 == r1);
+
+    std::size_t first = out.size();
+    for (std::size_t r = r0; r <= r1; ++r) {
+        for (std::size_t c = c0; c <= c1; ++c) {
+            const Cell& cell = m_cells[r * m_cols + c];
+            //      out      id
+            std::size_t start = out.size();
+            out.resize(start + cell.count);
+            std::size_t found = collectOverlapsInBlocks(cell.blocks.data(), cell.count, query, out.data() + start);
+            std::size_t kept = 0;
+            for (std::size_t j = 0; j < found; ++j) {
+                std::size_t i = out[start + j];
+                const OverlapBlock& block = cell.blocks[i / 4];
+                std::size_t lane = i % 4;
+                // ,    ,    
+                //  :     () ,    
+                if (c != c0 && firstColumn(block.x0[lane]) < c) {
+                    continue;
+                }
+                if (r != r0 && firstRow(block.y0[lane]) < r) {
+                    continue;
+                }
+                out[start + kept++] = block.id[lane];
+            }
+            out.resize(start + kept);
+        }
+    }
+    //   id ;       
+    if (!singleCell) {
+        std::sort(out.begin() + first, out.end());
+    }
+}
+
+void SpatialGrid::collectAt(double px, double py, std::vector<std::size_t>& out) const {
+    std::size_t c, r, c1, r1;
+    cellRange(px, py, px, py, c, r, c1, r1);
+    //     ,         
+    const Cell& cell = m_cells[r * m_cols + c];
+    for (std::size_t i = 0; i < cell.count; ++i) {
+        const OverlapBlock& block = cell.blocks[i / 4];
+        std::size_t lane = i % 4;
+        if (block.x0[lane] <= px && px < block.x1[lane] && block.y0[lane] <= py && py < block.y1[lane]) {
+            out.push_back(block.id[lane]);
+        }
+    }
+}
+
+std::size_t SpatialGrid::topmostAt(double px, double py) const noexcept {
+    std::size_t c, r, c1, r1;
+    cellRange(px, py, px, py, c, r, c1, r1);
+    // id     :     - 
+    const Cell& cell = m_cells[r * m_cols + c];
+    for (std::size_t i = cell.count; i-- > 0;) {
+        const OverlapBlock& block = cell.blocks[i / 4];
+        std::size_t lane = i % 4;
+        if (block.x0[lane] <= px && px < block.x1[lane] && block.y0[lane] <= py && py < block.y1[lane]) {
+            return block.id[lane];
+        }
+    }
+    return kNoId;
+}
+
+void SpatialGrid::nearest(double px, double py, std::size_t k, std::vector<std::size_t>& out) const {
+    if (k == 0 || m_bounds.empty() || std::isnan(px) || std::isnan(py)) {
+        return;
+    }
+    std::size_t pc, pr, c1, r1;
+    cellRange(px, py, px, py, pc, pr, c1, r1);
+
+    // k  ( , id);    -   
+    using Candidate = std::pair<double, std::size_t>;
+    std::vector<Candidate> best;
+    best.reserve(k + 1);
+    auto considerCell = [&](std::size_t c, std::size_t r) {
+        const Cell& cell = m_cells[r * m_cols + c];
+        for (std::size_t i = 0; i < cell.count; ++i) {
+            const OverlapBlock& block = cell.blocks[i / 4];
+            std::size_t lane = i % 4;
+            double dx = std::max({ block.x0[lane] - px, 0.0, px - block.x1[lane] });
+            double dy = std::max({ block.y0[lane] - py, 0.0, py - block.y1[lane] });
+            Candidate candidate(dx * dx + dy * dy, block.id[lane]);
+            if (std::isnan(candidate.first) || (best.size() == k && !(candidate < best.front()))) {
+                continue;
+            }
+            //            
+            // (,     ):    ,  
+            //        
+            std::size_t rc0, rr0, rc1, rr1;
+            cellRange(block.x0[lane], block.y0[lane], block.x1[lane], block.y1[lane], rc0, rr0, rc1, rr1);
+            if (std::clamp(pc, rc0, rc1) != c || std::clamp(pr, rr0, rr1) != r) {
+                continue;
+            }
+            best.push_back(candidate);
+            std::push_heap(best.begin(), best.end());
+            if (best.size() > k) {
+                std::pop_heap(best.begin(), best.end());
+                best.pop_back();
+            }
+        }
+    };
+
+    //     . ,    ,   
+    //   ,         
+    const double inf = std::numeric_limits<double>::infinity();
+    for (std::size_t ring = 0; ; ++ring) {
+        bool hasLeft = pc >= ring;
+        bool hasTop = pr >= ring;
+        bool hasRight = pc + ring < m_cols;
+        bool hasBottom = pr + ring < m_rows;
+        if (!hasLeft && !hasTop && !hasRight && !hasBottom) {
+            break; //   
+        }
+        std::size_t c0 = hasLeft ? pc - ring : 0;
+        std::size_t cEnd = hasRight ? pc + ring : m_cols - 1;
+        std::size_t r0 = hasTop ? pr - ring : 0;
+        std::size_t rEnd = hasBottom ? pr + ring : m_rows - 1;
+        for (std::size_t c = c0; c <= cEnd; ++c) {
+            if (hasTop) {
+                considerCell(c, r0);
+            }
+            if (hasBottom && ring > 0) {
+                considerCell(c, rEnd);
+            }
+        }
+        for (std::size_t r = r0 + (hasTop ? 1 : 0); r + (hasBottom ? 1 : 0) <= rEnd; ++r) {
+            if (hasLeft) {
+                considerCell(c0, r);
+            }
+            if (hasRight && ring > 0) {
+                considerCell(cEnd, r);
+            }
+        }
+
+        if (best.size() == k) {
+            //      ,     
+            double bound = inf;
+            if (c0 > 0) {
+                bound = std::min(bound, px - (m_originX + static_cast<double>(c0) * m_cellWidth));
+            }
+            if (cEnd + 1 < m_cols) {
+                bound = std::min(bound, m_originX + static_cast<double>(cEnd + 1) * m_cellWidth - px);
+            }
+            if (r0 > 0) {
+                bound = std::min(bound, py - (m_originY + static_cast<double>(r0) * m_cellHeight));
+            }
+            if (rEnd + 1 < m_rows) {
+                bound = std::min(bound, m_originY + static_cast<double>(rEnd + 1) * m_cellHeight - py);
+            }
+            if (bound == inf || best.front().first < bound * bound) {
+                break;
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    for (const Candidate& candidate : best) {
+        out.push_back(candidate.second);
+    }
+}
+
+void SpatialGrid::resize(std::size_t cols, std::size_t rows) {
+    std::vector<Cell> cells(cols * rows); //  ,    
+
+    //   ,   ,    
+    std::size_t oldCols = m_cols;
+    std::size_t oldRows = m_rows;
+    double oldCellWidth = m_cellWidth;
+    double oldCellHeight = m_cellHeight;
+    std::size_t oldEntryCount = m_entryCount;
+    m_cells.swap(cells);
+
+    m_cols = cols;
+    m_rows = rows;
+    m_cellWidth = m_width / static_cast<double>(cols);
+    m_cellHeight = m_height / static_cast<double>(rows);
+    m_inverseCellWidth = static_cast<double>(cols) / m_width;
+    m_inverseCellHeight = static_cast<double>(rows) / m_height;
+    m_entryCount = 0;
+    try {
+        placeRange(0);
+    }
+    catch (...) {
+        m_cells.swap(cells);
+        m_cols = oldCols;
+        m_rows = oldRows;
+        m_cellWidth = oldCellWidth;
+        m_cellHeight = oldCellHeight;
+        m_inverseCellWidth = static_cast<double>(oldCols) / m_width;
+        m_inverseCellHeight = static_cast<double>(oldRows) / m_height;
+        m_entryCount = oldEntryCount;
+        throw;
+    }
+}
+
+void SpatialGrid::refineIfCrowded() noexcept {
+    //        
+    while (m_cols < kMaxSide && m_rows < kMaxSide) {
+        if (m_entryCount <= kCrowdedCell * m_cols * m_rows) {
+            return;
+        }
+        if (m_entryCount >= kMaxAverageSpan * m_bounds.size()) {
+            return; //    ,    
+        }
+
+        try {
+            resize(m_cols * 2, m_rows * 2);
+        }
+        catch (const std::bad_alloc&) {
+            //        -    
+            return;
+        }
+    }
+}
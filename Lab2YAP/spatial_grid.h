@@ -0,0 +1,127 @@
+#pragma once
+
+#include "overlap_kernels.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+//         .
+//      ,   ,
+//      ,    .
+//       4 (OverlapBlock)   SIMD-.
+class SpatialGrid {
+public:
+    SpatialGrid(double width, double height);
+    //    [originX, originX + width) x [originY, originY + height) ;
+    //        
+    SpatialGrid(double originX, double originY, double width, double height);
+
+    //     id.    :  (0, 1, 2...),
+    //      -  .       .
+    //   std::bad_alloc;       
+    void insert(std::size_t id, double x, double y, double w, double h);
+
+    //  count    firstId, firstId + 1, ...   x, y, w, h.
+    //         ,    .
+    //   ,   insert
+    void insertBatch(std::size_t firstId, const double* x, const double* y, const double* w, const double* h,
+        std::size_t count);
+
+    // :      >= firstId
+    // (      )
+    void truncate(std::size_t firstId) noexcept;
+
+    //      ,   
+    //    Rectangle::overlaps (  -  )
+    bool anyOverlap(double x, double y, double w, double h) const noexcept;
+
+    //  id       kNoId,   
+    static const std::size_t kNoId = static_cast<std::size_t>(-1);
+    std::size_t findOverlap(double x, double y, double w, double h) const noexcept;
+
+    //   Screen::queryRegion, hitTest, kNearest.    out.
+    // id  ,   [x, x + w) x [y, y + h),   ( )
+    void collectOverlaps(double x, double y, double w, double h, std::vector<std::size_t>& out) const;
+    // id  ,   (x0 <= px < x1, y0 <= py < y1),  
+    void collectAt(double px, double py, std::vector<std::size_t>& out) const;
+    //  id    (  )  kNoId
+    std::size_t topmostAt(double px, double py) const noexcept;
+    // k    (  , 0 -   ),
+    //   ,   -  id
+    void nearest(double px, double py, std::size_t k, std::vector<std::size_t>& out) const;
+
+    //   .      compact(),
+    //   remove -       .
+    //   id    (  )  kNoId,   
+    std::size_t position(std::size_t id) const noexcept;
+    std::size_t idAt(std::size_t position) const noexcept { return m_bounds[position].id; }
+    // false,   id 
+    bool remove(std::size_t id) noexcept;
+    //    id (id    ):   
+    //    .  std::bad_alloc    
+    void update(std::size_t id, double x, double y, double w, double h);
+    //   ;    
+    void compact() noexcept;
+
+    //  ,    compact()
+    std::size_t size() const noexcept { return m_bounds.size(); }
+
+private:
+    //   ,       
+    struct Entry {
+        double x0;
+        double y0;
+        double x1;
+        double y1;
+        std::size_t id; //   ,  OverlapBlock::id
+        bool removed = false; //   ,  compact()
+    };
+
+    //   :   id   4 (    )
+    struct Cell {
+        std::vector<OverlapBlock> blocks;
+        std::size_t count = 0; //    
+
+        //   std::bad_alloc;      
+        void push_back(const Entry& entry);
+        void pop_back() noexcept;
+        //     id  count,   
+        std::size_t find(std::size_t id) const noexcept;
+        //      id;    push_back
+        void insertOrdered(const Entry& entry);
+        //     slot   
+        void erase(std::size_t slot) noexcept;
+    };
+
+    double m_originX;
+    double m_originY;
+    double m_width;
+    double m_height;
+    std::size_t m_cols;
+    std::size_t m_rows;
+    double m_cellWidth;
+    double m_cellHeight;
+    double m_inverseCellWidth;  //    :    
+    double m_inverseCellHeight;
+    std::size_t m_entryCount; //       
+    std::vector<Cell> m_cells;
+    std::vector<Entry> m_bounds; //   id,    
+
+    //   [c0, c1] x [r0, r1],   
+    void cellRange(double x0, double y0, double x1, double y1,
+        std::size_t& c0, std::size_t& r0, std::size_t& c1, std::size_t& r1) const noexcept;
+
+    //   ()      ()  x0 (y0)
+    std::size_t firstColumn(double x0) const noexcept;
+    std::size_t firstRow(double y0) const noexcept;
+
+    //          side x side (  )
+    std::size_t estimateEntries(std::size_t side) const noexcept;
+
+    void placeEntry(const Entry& entry);
+    //     m_bounds   first;     ,
+    //    std::bad_alloc   
+    void placeRange(std::size_t first);
+    void resize(std::size_t cols, std::size_t rows);
+    void refineIfCrowded() noexcept;
+};
@@ -0,0 +1,369 @@
+#include "svg_optimizer.h"
+#include <algorithm> //  std::sort, std::max, std::min
+#include <array>
+#include <cmath>     //  std::round, std::floor, std::nextafter
+
+namespace {
+    //    stroke-width 1  :     
+    const double kStrokeHalfWidth = 0.5;
+    //     ;   
+    //  ,        
+    const size_t kMaxCoverParts = 16;
+    //    ColorTrail
+    const size_t kMaxTrailCells = size_t(1) << 18;
+    const size_t kNoGroup = static_cast<size_t>(-1);
+
+    //     ,      
+    struct Edges {
+        double x0, y0, x1, y1;
+
+        bool contains(const Edges& other) const noexcept {
+            return x0 <= other.x0 && y0 <= other.y0 && other.x1 <= x1 && other.y1 <= y1;
+        }
+        bool intersects(const Edges& other) const noexcept {
+            return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1;
+        }
+    };
+
+    struct Item {
+        SvgBox box;
+        Color color;
+        bool removed;
+        bool culled;
+        size_t group;
+
+        Edges edges() const noexcept { return { box.x, box.y, box.x + box.w, box.y + box.h }; }
+        //     :   -     
+        Edges footprint() const noexcept {
+            Edges result = edges();
+            if (color == Color::None) {
+                result.x0 -= kStrokeHalfWidth;
+                result.y0 -= kStrokeHalfWidth;
+                result.x1 += kStrokeHalfWidth;
+                result.y1 += kStrokeHalfWidth;
+            }
+            return result;
+        }
+    };
+
+    struct Group {
+        size_t firstSlot; //     
+        Color color;
+    };
+
+    //      :   -    ,
+    //  ,           (  +1,
+    // 0 - ).     ,     
+    //    :     ,   
+    class ColorTrail {
+    public:
+        ColorTrail(double width, double height, double side) {
+            if (!(side > 0)) {
+                side = 1.0;
+            }
+            //   ,    kMaxTrailCells   
+            side = std::max(side, std::sqrt(width * height / static_cast<double>(kMaxTrailCells)));
+            m_cols = std::min<size_t>(static_cast<size_t>(width / side) + 1, kMaxTrailCells);
+            m_rows = std::min<size_t>(static_cast<size_t>(height / side) + 1, kMaxTrailCells / m_cols);
+            m_inverseSide = 1.0 / side;
+            m_cells.resize(m_cols * m_rows);
+        }
+
+        //   (+1)      color,   
+        size_t lastOther(const Edges& area, Color color) const noexcept {
+            size_t c0, r0, c1, r1;
+            range(area, c0, r0, c1, r1);
+            size_t result = 0;
+            for (size_t r = r0; r <= r1; ++r) {
+                for (size_t c = c0; c <= c1; ++c) {
+                    const Cell& cell = m_cells[r * m_cols + c];
+                    result = std::max(result, cell.lastColor != color ? cell.last : cell.lastOther);
+                }
+            }
+            return result;
+        }
+
+        void mark(const Edges& area, size_t slot, Color color) noexcept {
+            size_t c0, r0, c1, r1;
+            range(area, c0, r0, c1, r1);
+            for (size_t r = r0; r <= r1; ++r) {
+                for (size_t c = c0; c <= c1; ++c) {
+                    Cell& cell = m_cells[r * m_cols + c];
+                    if (cell.last != 0 && cell.lastColor != color) {
+                        cell.lastOther = cell.last; //   -    
+                    }
+                    cell.last = slot + 1;
+                    cell.lastColor = color;
+                }
+            }
+        }
+
+    private:
+        struct Cell {
+            size_t last = 0;
+            size_t lastOther = 0;
+            Color lastColor = Color::None;
+        };
+
+        size_t index(double value, size_t count) const noexcept {
+            double cell = std::floor(value * m_inverseSide);
+            return cell <= 0 ? 0 : std::min(static_cast<size_t>(cell), count - 1);
+        }
+        void range(const Edges& area, size_t& c0, size_t& r0, size_t& c1, size_t& r1) const noexcept {
+            c0 = index(area.x0, m_cols);
+            c1 = index(area.x1, m_cols);
+            r0 = index(area.y0, m_rows);
+            r1 = index(area.y1, m_rows);
+        }
+
+        size_t m_cols;
+        size_t m_rows;
+        double m_inverseSide;
+        std::vector<Cell> m_cells;
+    };
+
+    //    ;   quantum    
+    SvgBox printedBox(double x, double y, double w, double h, double quantum) noexcept {
+        if (quantum > 0) {
+            double x0 = std::round(x / quantum) * quantum;
+            double y0 = std::round(y / quantum) * quantum;
+            double x1 = std::max(std::round((x + w) / quantum) * quantum, x0 + quantum);
+            double y1 = std::max(std::round((y + h) / quantum) * quantum, y0 + quantum);
+            x = x0;
+            y = y0;
+            w = x1 - x0;
+            h = y1 - y0;
+        }
+        return { SvgWriter::printedValue(x), SvgWriter::printedValue(y),
+            SvgWriter::printedValue(w), SvgWriter::printedValue(h) };
+    }
+
+    //   target  covers:      
+    bool isCovered(const Edges& target, const std::vector<Edges>& covers,
+        std::vector<double>& xs, std::vector<double>& ys)
+    {
+        for (const Edges& cover : covers) {
+            if (cover.contains(target)) {
+                return true;
+            }
+        }
+        if (covers.size() < 2 || covers.size() > kMaxCoverParts) {
+            return false;
+        }
+        xs.assign({ target.x0, target.x1 });
+        ys.assign({ target.y0, target.y1 });
+        for (const Edges& cover : covers) {
+            xs.push_back(std::min(std::max(cover.x0, target.x0), target.x1));
+            xs.push_back(std::min(std::max(cover.x1, target.x0), target.x1));
+            ys.push_back(std::min(std::max(cover.y0, target.y0), target.y1));
+            ys.push_back(std::min(std::max(cover.y1, target.y0), target.y1));
+        }
+        std::sort(xs.begin(), xs.end());
+        xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+        std::sort(ys.begin(), ys.end());
+        ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+        for (size_t i = 0; i + 1 < xs.size(); ++i) {
+            for (size_t j = 0; j + 1 < ys.size(); ++j) {
+                Edges cell = { xs[i], ys[j], xs[i + 1], ys[j + 1] };
+                bool covered = false;
+                for (const Edges& cover : covers) {
+                    if (cover.contains(cell)) {
+                        covered = true;
+                        break;
+                    }
+                }
+                if (!covered) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //    :   ( y  h) -  
+    //   x,     .     ()
+    //          
+    void coalesce(std::vector<SvgBox>& boxes) {
+        auto mergePass = [&boxes](bool rows) {
+            auto key = [rows](const SvgBox& box) {
+                return rows ? std::array<double, 3>{ box.y, box.h, box.x } : std::array<double, 3>{ box.x, box.w, box.y };
+            };
+            std::sort(boxes.begin(), boxes.end(), [&](const SvgBox& a, const SvgBox& b) { return key(a) < key(b); });
+            size_t out = 0;
+            for (size_t i = 0; i < boxes.size(); ++i) {
+                if (out > 0) {
+                    SvgBox& last = boxes[out - 1];
+                    const SvgBox& next = boxes[i];
+                    double lastStart = rows ? last.x : last.y;
+                    double lastSize = rows ? last.w : last.h;
+                    double nextStart = rows ? next.x : next.y;
+                    double nextSize = rows ? next.w : next.h;
+                    bool sameLine = rows ? (last.y == next.y && last.h == next.h) : (last.x == next.x && last.w == next.w);
+                    double end = std::max(lastStart + lastSize, nextStart + nextSize);
+                    double size = end - lastStart;
+                    if (sameLine && nextStart <= lastStart + lastSize &&
+                        SvgWriter::printedValue(size) == size && lastStart + size == end)
+                    {
+                        (rows ? last.w : last.h) = size;
+                        continue;
+                    }
+                }
+                boxes[out++] = boxes[i];
+            }
+            boxes.resize(out);
+        };
+        mergePass(true);
+        mergePass(false);
+    }
+}
+
+SvgExportSummary writeOptimizedRectangles(SvgWriter& writer, const RectangleStore& rectangles,
+    const SpatialGrid& index, double width, double height, const SvgExportOptions& options)
+{
+    SvgExportSummary summary;
+    const size_t count = rectangles.size();
+    const double quantum = std::isfinite(options.quantum) && options.quantum > 0 ? options.quantum : 0.0;
+    //      :    ,   
+    // (6  )    ,    
+    const double margin = kStrokeHalfWidth + quantum + (width + height) * 1e-5;
+
+    std::vector<Item> items(count);
+    for (size_t i = 0; i < count; ++i) {
+        Item& item = items[i];
+        item.removed = rectangles.isRemoved(i);
+        item.culled = false;
+        item.group = kNoGroup;
+        item.color = rectangles.getColor(i);
+        item.box = printedBox(rectangles.getX(i), rectangles.getY(i),
+            rectangles.getWidth(i), rectangles.getHeight(i), quantum);
+        summary.rectangles += !item.removed;
+    }
+
+    std::vector<size_t> neighbours;
+    //   ,    area (   slot)
+    auto collectNeighbours = [&](size_t slot, const Edges& area) {
+        double x0 = std::min(rectangles.getX(slot), area.x0) - margin;
+        double y0 = std::min(rectangles.getY(slot), area.y0) - margin;
+        double x1 = std::max(rectangles.getX(slot) + rectangles.getWidth(slot), area.x1) + margin;
+        double y1 = std::max(rectangles.getY(slot) + rectangles.getHeight(slot), area.y1) + margin;
+        neighbours.clear();
+        index.collectOverlaps(x0, y0, x1 - x0, y1 - y0, neighbours);
+        for (size_t& id : neighbours) {
+            id = index.position(id); //       (  )
+        }
+    };
+
+    // 1. : ,   ,     .
+    //       (     ).
+    //      :     
+    //    ;  ,  - , 
+    if (options.cullOccluded) {
+        std::vector<Edges> covers;
+        std::vector<double> xs;
+        std::vector<double> ys;
+        for (size_t i = 0; i < count; ++i) {
+            if (items[i].removed) {
+                continue;
+            }
+            Edges target = items[i].footprint();
+            //         (x0 <= px < x1) -    
+            double right = std::nextafter(target.x1, target.x0);
+            double bottom = std::nextafter(target.y1, target.y0);
+            neighbours.clear();
+            index.collectAt(target.x0, target.y0, neighbours);
+            index.collectAt(right, target.y0, neighbours);
+            index.collectAt(target.x0, bottom, neighbours);
+            index.collectAt(right, bottom, neighbours);
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+            covers.clear();
+            for (size_t id : neighbours) {
+                size_t slot = index.position(id);
+                if (slot > i && items[slot].color != Color::None) {
+                    covers.push_back(items[slot].edges());
+                }
+            }
+            if (!covers.empty() && isCovered(target, covers, xs, ys)) {
+                items[i].culled = true;
+                ++summary.culled;
+            }
+        }
+    }
+
+    // 2. :   ,     , 
+    //          ,   .
+    // ,     ,     ,   
+    //     .    ,  
+    // SpatialGrid ,      
+    double sideSum = 0;
+    for (const Item& item : items) {
+        if (!item.removed && !item.culled) {
+            sideSum += std::max(item.box.w, item.box.h);
+        }
+    }
+    size_t visible = summary.rectangles - summary.culled;
+    ColorTrail trail(width, height, visible > 0 ? sideSum / static_cast<double>(visible) : 0.0);
+    std::vector<Group> groups;
+    std::array<size_t, kColorCount> lastGroup;
+    lastGroup.fill(kNoGroup);
+    for (size_t i = 0; i < count; ++i) {
+        Item& item = items[i];
+        if (item.removed || item.culled) {
+            continue;
+        }
+        size_t colorIndex = static_cast<size_t>(item.color);
+        size_t candidate = options.mergeColors ? lastGroup[colorIndex] : kNoGroup;
+        Edges footprint = item.footprint();
+        size_t groupStart = candidate != kNoGroup ? groups[candidate].firstSlot : 0;
+        if (candidate != kNoGroup && trail.lastOther(footprint, item.color) > groupStart + 1) {
+            collectNeighbours(i, footprint);
+            for (size_t slot : neighbours) {
+                const Item& other = items[slot];
+                if (slot > groupStart && slot < i && !other.culled && other.color != item.color &&
+                    footprint.intersects(other.footprint()))
+                {
+                    candidate = kNoGroup;
+                    break;
+                }
+            }
+        }
+        if (candidate == kNoGroup) {
+            candidate = groups.size();
+            groups.push_back({ i, item.color });
+            lastGroup[colorIndex] = candidate;
+        }
+        item.group = candidate;
+        trail.mark(footprint, i, item.color);
+    }
+
+    // 3.      
+    std::vector<size_t> offsets(groups.size() + 1, 0);
+    for (const Item& item : items) {
+        if (item.group != kNoGroup) {
+            ++offsets[item.group + 1];
+        }
+    }
+    for (size_t g = 0; g < groups.size(); ++g) {
+        offsets[g + 1] += offsets[g];
+    }
+    std::vector<SvgBox> members(offsets.back());
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (const Item& item : items) {
+        if (item.group != kNoGroup) {
+            members[fill[item.group]++] = item.box;
+        }
+    }
+
+    std::vector<SvgBox> boxes;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        boxes.assign(members.begin() + static_cast<std::ptrdiff_t>(offsets[g]),
+            members.begin() + static_cast<std::ptrdiff_t>(offsets[g + 1]));
+        //   :       
+        if (boxes.size() > 1 && groups[g].color != Color::None) {
+            coalesce(boxes);
+        }
+        writer.writeRectangles(boxes, Rectangle::colorName(groups[g].color));
+        ++summary.elements;
+    }
+    return summary;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "rectangle_store.h"
+#include "spatial_grid.h"
+#include "svg_writer.h"
+#include <cstdint>
+
+//    (Screen::saveSVGOptimized)
+struct SvgExportOptions {
+    //   ,     
+    bool cullOccluded = true;
+    //       <path>,     ,
+    //         
+    bool mergeColors = true;
+    //    (0 -  ).     
+    //  ,     ;    ,  
+    //     -        
+    double quantum = 0.0;
+};
+
+//   
+struct SvgExportSummary {
+    size_t rectangles = 0; //  
+    size_t culled = 0;     //      
+    size_t elements = 0;   //  <rect>  <path>
+    std::uint64_t bytes = 0;
+};
+
+//   (    ) ,   
+//    (   <rect>   )   
+// ,   raster.h.       ,      .
+//    -   1,      0.5    .
+//            .
+// index -   rectangles (      ).
+//     ,  bytes
+SvgExportSummary writeOptimizedRectangles(SvgWriter& writer, const RectangleStore& rectangles,
+    const SpatialGrid& index, double width, double height, const SvgExportOptions& options);
@@ -0,0 +1,159 @@
+#include "svg_writer.h"
+#include <charconv>  //  std::to_chars
+#include <cstring>   //  std::memcpy
+#include <exception> //  std::uncaught_exceptions
+
+namespace {
+    //   ;   <rect>   80 
+    const size_t kWriteBufferSize = 1 << 20;
+    //       %g (, 6 , , )
+    const size_t kMaxNumberLength = 32;
+}
+
+SvgWriter::SvgWriter(const std::string& filename)
+    : m_buffer(kWriteBufferSize), m_used(0), m_written(0)
+{
+    m_out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    //      :     
+    m_out.rdbuf()->pubsetbuf(nullptr, 0);
+    m_out.open(filename); //   ,      /
+}
+
+SvgWriter::SvgWriter(const std::string& filename, std::streamoff resumeAt)
+    : m_buffer(kWriteBufferSize), m_used(0), m_written(0)
+{
+    m_out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    m_out.rdbuf()->pubsetbuf(nullptr, 0);
+    // in | out -      (     )
+    m_out.open(filename, std::ios::in | std::ios::out);
+    m_out.seekp(resumeAt);
+}
+
+SvgWriter::~SvgWriter() {
+    //    :        
+    if (std::uncaught_exceptions() == 0) {
+        try {
+            flush();
+        }
+        catch (...) {
+        }
+    }
+}
+
+void SvgWriter::flush() {
+    if (m_used > 0) {
+        m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+        m_written += m_used;
+        m_used = 0;
+    }
+}
+
+std::streamoff SvgWriter::position() {
+    flush();
+    return static_cast<std::streamoff>(m_out.tellp());
+}
+
+void SvgWriter::reserve(size_t bytes) {
+    if (m_buffer.size() - m_used < bytes) {
+        flush();
+        if (m_buffer.size() < bytes) {
+            m_buffer.resize(bytes);
+        }
+    }
+}
+
+void SvgWriter::append(std::string_view text) {
+    reserve(text.size());
+    std::memcpy(m_buffer.data() + m_used, text.data(), text.size());
+    m_used += text.size();
+}
+
+void SvgWriter::appendNumber(double value) {
+    reserve(kMaxNumberLength);
+    char* first = m_buffer.data() + m_used;
+    // general +  6 -   ,  operator<<     
+    std::to_chars_result result = std::to_chars(first, first + kMaxNumberLength, value, std::chars_format::general, 6);
+    m_used += static_cast<size_t>(result.ptr - first);
+}
+
+void SvgWriter::writeHeader(double width, double height) {
+    append("<svg width=\"");
+    appendNumber(width);
+    append("\" height=\"");
+    appendNumber(height);
+    append("\" xmlns=\"http://www.w3.org/2000/svg\">\n");
+    append("  <rect width=\"100%\" height=\"100%\" fill=\"lightgrey\" />\n"); // 
+}
+
+void SvgWriter::writeRectangle(const Rectangle& rect) {
+    writeRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(), rect.getColor());
+}
+
+void SvgWriter::writeRectangle(double x, double y, double w, double h, std::string_view color) {
+    //   ,   Rectangle::drawSVG
+    append("  <rect x=\"");
+    appendNumber(x);
+    append("\" y=\"");
+    appendNumber(y);
+    append("\" width=\"");
+    appendNumber(w);
+    append("\" height=\"");
+    appendNumber(h);
+    append("\"");
+    if (!color.empty()) {
+        append(" fill=\"");
+        append(color);
+        append("\"");
+    }
+    else {
+        append(" fill=\"none\" stroke=\"black\""); //   ,  
+    }
+    append(" />\n");
+}
+
+void SvgWriter::writeRectangles(std::span<const SvgBox> boxes, std::string_view color) {
+    if (boxes.size() == 1) {
+        writeRectangle(boxes[0].x, boxes[0].y, boxes[0].w, boxes[0].h, color);
+        return;
+    }
+    if (boxes.empty()) {
+        return;
+    }
+    //     -    x + w  y + h,   <rect>
+    append("  <path d=\"");
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        append(i == 0 ? "M" : " M");
+        appendNumber(boxes[i].x);
+        append(" ");
+        appendNumber(boxes[i].y);
+        append("h");
+        appendNumber(boxes[i].w);
+        append("v");
+        appendNumber(boxes[i].h);
+        append("h");
+        appendNumber(-boxes[i].w);
+        append("z");
+    }
+    append("\"");
+    if (!color.empty()) {
+        append(" fill=\"");
+        append(color);
+        append("\"");
+    }
+    else {
+        append(" fill=\"none\" stroke=\"black\"");
+    }
+    append(" />\n");
+}
+
+double SvgWriter::printedValue(double value) noexcept {
+    char buffer[kMaxNumberLength];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    double printed = value;
+    std::from_chars(buffer, result.ptr, printed);
+    return printed;
+}
+
+void SvgWriter::writeFooter() {
+    append("</svg>\n");
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "rectangle.h"
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//   SvgWriter::writeRectangles
+struct SvgBox {
+    double x, y, w, h;
+};
+
+//   SVG    .
+//    std::to_chars  ,    std::ostream
+//   (%g, 6  ),     Rectangle::drawSVG   .
+//       write;      .
+//     std::ios_base::failure,   std::ofstream  exceptions().
+class SvgWriter {
+public:
+    explicit SvgWriter(const std::string& filename);
+    //    :     resumeAt ( 
+    //  ),   
+    SvgWriter(const std::string& filename, std::streamoff resumeAt);
+    ~SvgWriter(); //   ,    
+
+    SvgWriter(const SvgWriter&) = delete;
+    SvgWriter& operator=(const SvgWriter&) = delete;
+
+    void writeHeader(double width, double height);
+    void writeRectangle(const Rectangle& rect);
+    void writeRectangle(double x, double y, double w, double h, std::string_view color);
+    //      : <path>  ,  
+    //   ,    fill-rule   (nonzero)  .
+    //     <rect>.   - ,   writeRectangle
+    void writeRectangles(std::span<const SvgBox> boxes, std::string_view color);
+    void writeFooter();
+
+    //     (  write)
+    void flush();
+
+    // ,    :    (6  )
+    static double printedValue(double value) noexcept;
+    //        
+    std::streamoff position();
+    //        
+    std::uint64_t bytesWritten() const noexcept { return m_written; }
+
+private:
+    std::ofstream m_out;
+    std::vector<char> m_buffer;
+    size_t m_used;
+    std::uint64_t m_written;
+
+    void append(std::string_view text);
+    void appendNumber(double value);
+    void reserve(size_t bytes); //      -  
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+//  : threadCount    0..taskCount-1   .
+//      (   ,   std::exception_ptr)
+template <typename Task>
+void runOnThreads(std::size_t threadCount, std::size_t taskCount, Task task) {
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < taskCount; i = next++) {
+            task(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    try {
+        for (std::size_t t = 1; t < threadCount; ++t) {
+            threads.emplace_back(worker);
+        }
+    }
+    catch (...) {
+        //     -    
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
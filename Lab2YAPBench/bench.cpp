@@ -0,0 +1,1047 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <limits>    //  std::numeric_limits
+#include <cstdio>    //  std::remove
+#include <fstream>
+#include <memory_resource>
+#include <future>
+#include <thread>
+#include <algorithm> //  std::min, std::max
+#include <cmath>     //  std::sqrt
+#include <string_view>
+#include <iterator>  //  std::size
+#include <string>
+#include <cstring>   //  std::strlen, std::strchr
+#include <cstdlib>   //  std::strtod
+#include "screen.h"
+#include "overlap_kernels.h"
+#include "concurrent_screen.h"
+#include "raster.h"
+#include "suite.h"
+
+//   Screen.   Release,     .
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    //      notOverlap=true   
+    std::vector<Rectangle> makeRectangles(size_t count, double screenSize, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> pos(0.0, screenSize - 40.0);
+        std::uniform_real_distribution<double> size(2.0, 40.0);
+
+        std::vector<Rectangle> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.emplace_back(pos(rng), pos(rng), size(rng), size(rng), "", true);
+        }
+        return result;
+    }
+
+    //  :     
+    size_t insertWithLinearScan(const std::vector<Rectangle>& input, double screenSize) {
+        std::vector<Rectangle> placed;
+        for (const auto& rect : input) {
+            if (rect.getX() < 0 || rect.getY() < 0 ||
+                rect.getX() + rect.getWidth() > screenSize ||
+                rect.getY() + rect.getHeight() > screenSize)
+            {
+                continue;
+            }
+            bool overlap = false;
+            for (const auto& existingRect : placed) {
+                if (rect.overlaps(existingRect)) {
+                    overlap = true;
+                    break;
+                }
+            }
+            if (!overlap) {
+                placed.push_back(rect);
+            }
+        }
+        return placed.size();
+    }
+
+    size_t insertWithScreen(const std::vector<Rectangle>& input, double screenSize) {
+        Screen screen(screenSize, screenSize);
+        for (const auto& rect : input) {
+            screen.tryAddRectangle(rect);
+        }
+        return screen.getRectangles().size();
+    }
+
+    void benchOverlapIndex(size_t count) {
+        const double screenSize = 20000.0;
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 42);
+
+        Clock::time_point start = Clock::now();
+        size_t linearPlaced = insertWithLinearScan(input, screenSize);
+        double linearTime = secondsSince(start);
+
+        start = Clock::now();
+        size_t gridPlaced = insertWithScreen(input, screenSize);
+        double gridTime = secondsSince(start);
+
+        std::cout << "notOverlap insert, " << count << " rects: "
+            << "linear scan " << linearTime << " s, "
+            << "grid " << gridTime << " s, "
+            << "speedup x" << (gridTime > 0 ? linearTime / gridTime : 0.0) << "\n";
+        if (linearPlaced != gridPlaced) {
+            std::cerr << "  MISMATCH: linear placed " << linearPlaced << ", grid placed " << gridPlaced << "\n";
+        }
+    }
+
+    //    (tryAddRectangle)   (tryAddRectangles)
+    void benchBatchInsert(size_t count) {
+        const double screenSize = 20000.0;
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 42);
+
+        Clock::time_point start = Clock::now();
+        size_t singlePlaced = insertWithScreen(input, screenSize);
+        double singleTime = secondsSince(start);
+
+        start = Clock::now();
+        Screen screen(screenSize, screenSize);
+        BatchStatus status = screen.tryAddRectangles(input);
+        double batchTime = secondsSince(start);
+
+        std::cout << "insert, " << count << " rects: "
+            << "one by one " << singleTime << " s, "
+            << "batch " << batchTime << " s, "
+            << "speedup x" << (batchTime > 0 ? singleTime / batchTime : 0.0) << "\n";
+        if (singlePlaced != status.addedCount()) {
+            std::cerr << "  MISMATCH: one by one placed " << singlePlaced << ", batch placed " << status.addedCount() << "\n";
+        }
+    }
+
+    //    :  (loadFromFile)   
+    void benchSceneReload(size_t count) {
+        const double screenSize = 20000.0;
+        const char* textFile = "bench_scene.txt";
+        const char* binaryFile = "bench_scene.bin";
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 11);
+
+        Screen source(screenSize, screenSize);
+        std::ofstream text(textFile);
+        for (const auto& rect : input) {
+            source.addRectangle(Rectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(), "red"));
+            text << rect.getX() + rect.getWidth() / 2 << " " << rect.getY() + rect.getHeight() / 2 << " "
+                << rect.getWidth() << " " << rect.getHeight() << " red\n";
+        }
+        text.close();
+        source.saveBinary(binaryFile);
+
+        Clock::time_point start = Clock::now();
+        Screen fromText(screenSize, screenSize);
+        fromText.loadFromFile(textFile, LoadMode::Mapped);
+        double textTime = secondsSince(start);
+
+        start = Clock::now();
+        Screen fromBinary = Screen::fromBinary(binaryFile);
+        double binaryTime = secondsSince(start);
+
+        std::cout << "scene reload, " << count << " rects: "
+            << "text " << textTime << " s, "
+            << "binary " << binaryTime << " s, "
+            << "speedup x" << (binaryTime > 0 ? textTime / binaryTime : 0.0) << "\n";
+        if (fromText.getRectangles().size() != fromBinary.getRectangles().size()) {
+            std::cerr << "  MISMATCH: text loaded " << fromText.getRectangles().size()
+                << ", binary loaded " << fromBinary.getRectangles().size() << "\n";
+        }
+        std::remove(textFile);
+        std::remove(binaryFile);
+    }
+
+    //   " - ":       
+    //  clear() ( )     
+    void benchLoadClearCycles(size_t count, int cycles) {
+        const double screenSize = 20000.0;
+        const char* textFile = "bench_cycles.txt";
+        {
+            std::ofstream text(textFile);
+            for (const auto& rect : makeRectangles(count, screenSize, 13)) {
+                text << rect.getX() + rect.getWidth() / 2 << " " << rect.getY() + rect.getHeight() / 2 << " "
+                    << rect.getWidth() << " " << rect.getHeight() << " blue\n";
+            }
+        }
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < cycles; ++i) {
+            Screen screen(screenSize, screenSize);
+            screen.loadFromFile(textFile, LoadMode::Mapped);
+        }
+        double freshTime = secondsSince(start);
+
+        start = Clock::now();
+        Screen reused(screenSize, screenSize);
+        for (int i = 0; i < cycles; ++i) {
+            reused.clear();
+            reused.loadFromFile(textFile, LoadMode::Mapped);
+        }
+        double reusedTime = secondsSince(start);
+
+        std::pmr::unsynchronized_pool_resource pool;
+        start = Clock::now();
+        for (int i = 0; i < cycles; ++i) {
+            Screen screen(screenSize, screenSize, &pool);
+            screen.loadFromFile(textFile, LoadMode::Mapped);
+        }
+        double poolTime = secondsSince(start);
+
+        std::cout << "load/clear, " << cycles << " x " << count << " rects: "
+            << "new screen " << freshTime << " s, "
+            << "clear() " << reusedTime << " s, "
+            << "pool resource " << poolTime << " s\n";
+        std::remove(textFile);
+    }
+
+    //       :
+    //  Rectangle::overlaps  SIMD- findOverlapping
+    void benchDenseOverlap(size_t count, size_t queries) {
+        const double screenSize = 2000.0; //   -  
+        Screen screen(screenSize, screenSize);
+        std::vector<Rectangle> stored = makeRectangles(count, screenSize, 7);
+        for (const auto& rect : stored) {
+            screen.addRectangle(Rectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight()));
+        }
+        std::vector<Rectangle> candidates = makeRectangles(queries, screenSize, 8);
+
+        Clock::time_point start = Clock::now();
+        size_t scalarHits = 0;
+        for (const auto& candidate : candidates) {
+            for (const auto& rect : stored) {
+                if (candidate.overlaps(rect)) {
+                    ++scalarHits;
+                }
+            }
+        }
+        double scalarTime = secondsSince(start);
+        std::cout << "dense overlap, " << count << " rects x " << queries << " queries: "
+            << "Rectangle::overlaps " << scalarTime << " s";
+
+        OverlapKernel best = activeOverlapKernel();
+        const OverlapKernel kernels[] = { OverlapKernel::Scalar, OverlapKernel::Sse2, OverlapKernel::Avx };
+        for (OverlapKernel kernel : kernels) {
+            if (!selectOverlapKernel(kernel)) {
+                continue; //   
+            }
+            start = Clock::now();
+            size_t hits = 0;
+            for (const auto& candidate : candidates) {
+                hits += screen.findOverlapping(candidate).size();
+            }
+            double time = secondsSince(start);
+            std::cout << ", " << overlapKernelName(kernel) << " " << time << " s (x"
+                << (time > 0 ? scalarTime / time : 0.0) << ")";
+            if (hits != scalarHits) {
+                std::cerr << "\n  MISMATCH: " << overlapKernelName(kernel) << " found " << hits
+                    << ", Rectangle::overlaps found " << scalarHits;
+            }
+        }
+        selectOverlapKernel(best);
+        std::cout << "\n";
+    }
+
+    //      (     
+    // ):   Rectangle    emplace   
+    void benchInsertPath(size_t count) {
+        const double screenSize = 4000.0;
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 11);
+        std::vector<double> xs, ys, ws, hs;
+        for (const Rectangle& rect : input) {
+            xs.push_back(rect.getX());
+            ys.push_back(rect.getY());
+            ws.push_back(rect.getWidth());
+            hs.push_back(rect.getHeight());
+        }
+
+        auto run = [&](const char* name, auto insert) {
+            Screen screen(screenSize, screenSize);
+            Clock::time_point start = Clock::now();
+            size_t rejected = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (!insert(screen, i)) {
+                    ++rejected;
+                }
+            }
+            std::cout << name << " " << secondsSince(start) << " s (" << rejected << " rejected); ";
+        };
+
+        std::cout << "single insert, " << count << " rects: ";
+        run("addRectangle", [&](Screen& screen, size_t i) {
+            try {
+                screen.addRectangle(Rectangle(xs[i], ys[i], ws[i], hs[i], "", true));
+                return true;
+            }
+            catch (const ScreenError&) {
+                return false;
+            }
+        });
+        run("tryAddRectangle", [&](Screen& screen, size_t i) {
+            return screen.tryAddRectangle(Rectangle(xs[i], ys[i], ws[i], hs[i], "", true));
+        });
+        run("emplaceRectangle", [&](Screen& screen, size_t i) {
+            try {
+                screen.emplaceRectangle(xs[i], ys[i], ws[i], hs[i], Color::None, true);
+                return true;
+            }
+            catch (const ScreenError&) {
+                return false;
+            }
+        });
+        run("tryEmplaceRectangle", [&](Screen& screen, size_t i) {
+            return screen.tryEmplaceRectangle(xs[i], ys[i], ws[i], hs[i], Color::None, true);
+        });
+        run("insertRectangle", [&](Screen& screen, size_t i) {
+            return screen.insertRectangle(xs[i], ys[i], ws[i], hs[i], Color::None, true).has_value();
+        });
+        std::cout << "\n";
+    }
+
+    //    ,     :
+    //   saveSVG   saveSVGIncremental
+    void benchIncrementalSVG(size_t count, int snapshots) {
+        const double screenSize = 20000.0;
+        const size_t perSnapshot = 100;
+        std::vector<Rectangle> input = makeRectangles(count + perSnapshot * snapshots, screenSize, 5);
+        const char* fullFile = "bench_full.svg";
+        const char* incrementalFile = "bench_incremental.svg";
+
+        Screen screen(screenSize, screenSize);
+        for (size_t i = 0; i < count; ++i) {
+            screen.emplaceRectangle(input[i].getX(), input[i].getY(), input[i].getWidth(), input[i].getHeight());
+        }
+        screen.saveSVGIncremental(incrementalFile);
+
+        double fullTime = 0;
+        double incrementalTime = 0;
+        for (int s = 0; s < snapshots; ++s) {
+            for (size_t i = 0; i < perSnapshot; ++i) {
+                const Rectangle& rect = input[count + s * perSnapshot + i];
+                screen.emplaceRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight());
+            }
+            Clock::time_point start = Clock::now();
+            screen.saveSVG(fullFile);
+            fullTime += secondsSince(start);
+
+            start = Clock::now();
+            screen.saveSVGIncremental(incrementalFile);
+            incrementalTime += secondsSince(start);
+        }
+        std::remove(fullFile);
+        std::remove(incrementalFile);
+
+        std::cout << "SVG snapshots, " << count << " rects + " << perSnapshot << " per snapshot, "
+            << snapshots << " snapshots: saveSVG " << fullTime << " s, saveSVGIncremental "
+            << incrementalTime << " s\n";
+    }
+
+    //      : saveSVG     saveSVGAsync;
+    //     ,     
+    void benchAsyncSVG(size_t count) {
+        const double screenSize = 20000.0;
+        std::vector<Rectangle> input = makeRectangles(count * 2, screenSize, 9);
+        const char* file = "bench_async.svg";
+
+        Screen screen(screenSize, screenSize);
+        for (size_t i = 0; i < count; ++i) {
+            screen.emplaceRectangle(input[i].getX(), input[i].getY(), input[i].getWidth(), input[i].getHeight());
+        }
+
+        Clock::time_point start = Clock::now();
+        screen.saveSVG(file);
+        double syncTime = secondsSince(start);
+
+        start = Clock::now();
+        std::future<void> done = screen.saveSVGAsync(file);
+        double blockedTime = secondsSince(start);
+        size_t addedMeanwhile = 0;
+        while (done.wait_for(std::chrono::seconds(0)) != std::future_status::ready && count + addedMeanwhile < input.size()) {
+            const Rectangle& rect = input[count + addedMeanwhile++];
+            screen.emplaceRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight());
+        }
+        done.get();
+        double asyncTime = secondsSince(start);
+        std::remove(file);
+
+        std::cout << "SVG export, " << count << " rects: saveSVG blocks " << syncTime
+            << " s, saveSVGAsync blocks " << blockedTime << " s (done in " << asyncTime
+            << " s, " << addedMeanwhile << " rects added meanwhile)\n";
+    }
+
+    //    ConcurrentScreen:       .
+    //       -      
+    void benchConcurrentInsert(size_t count) {
+        const double screenSize = 20000.0;
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 17);
+
+        Clock::time_point start = Clock::now();
+        size_t placed = insertWithScreen(input, screenSize);
+        std::cout << "concurrent insert, " << count << " rects: Screen " << secondsSince(start)
+            << " s (" << placed << " placed)";
+
+        size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+        for (size_t threadCount = 1; threadCount <= std::max<size_t>(hardware, 4); threadCount *= 2) {
+            //   t: ,   x   t-  
+            std::vector<std::vector<Rectangle>> bands(threadCount);
+            for (const Rectangle& rect : input) {
+                size_t band = std::min(threadCount - 1, static_cast<size_t>(rect.getX() / screenSize * threadCount));
+                bands[band].push_back(rect);
+            }
+
+            ConcurrentScreen screen(screenSize, screenSize);
+            start = Clock::now();
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&screen, &band = bands[t]]() {
+                    for (const Rectangle& rect : band) {
+                        screen.insertRectangle(rect);
+                    }
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            std::cout << ", " << threadCount << " threads " << secondsSince(start) << " s";
+        }
+        std::cout << " (hardware threads: " << hardware << ")\n";
+    }
+
+    //       RGBA   PPM
+    void benchRasterize(size_t count) {
+        const double screenSize = 4000.0;
+        std::mt19937 rng(23);
+        std::uniform_real_distribution<double> pos(0.0, screenSize - 40.0);
+        std::uniform_real_distribution<double> size(2.0, 40.0);
+        Screen screen(screenSize, screenSize);
+        for (size_t i = 0; i < count; ++i) {
+            screen.emplaceRectangle(pos(rng), pos(rng), size(rng), size(rng), static_cast<Color>(i % kColorCount));
+        }
+
+        std::cout << "rasterize, " << count << " rects into " << screenSize << "x" << screenSize << ":";
+        size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+        for (size_t threadCount = 1; threadCount <= std::max<size_t>(hardware, 4); threadCount *= 2) {
+            Clock::time_point start = Clock::now();
+            Framebuffer frame = renderScreen(screen, threadCount);
+            std::cout << " " << threadCount << " threads " << secondsSince(start) << " s,";
+        }
+
+        Framebuffer frame = renderScreen(screen);
+        const char* file = "bench_raster.ppm";
+        Clock::time_point start = Clock::now();
+        frame.savePPM(file);
+        std::cout << " savePPM " << secondsSince(start) << " s\n";
+        std::remove(file);
+    }
+
+    //    :  (hitTest),    k   
+    //     
+    void benchQueries(size_t count, size_t queries) {
+        const double screenSize = 20000.0;
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 29);
+        Screen screen(screenSize, screenSize);
+        for (const Rectangle& rect : input) {
+            screen.emplaceRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight());
+        }
+        const RectangleStore& rects = screen.getRectangles();
+
+        std::mt19937 rng(31);
+        std::uniform_real_distribution<double> pos(0.0, screenSize);
+        std::vector<double> px(queries), py(queries);
+        for (size_t i = 0; i < queries; ++i) {
+            px[i] = pos(rng);
+            py[i] = pos(rng);
+        }
+
+        size_t hits = 0;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < queries; ++i) {
+            hits += screen.hitTest(px[i], py[i]) != Screen::npos;
+        }
+        double hitTime = secondsSince(start);
+
+        //    -    ,   
+        size_t linearQueries = std::min<size_t>(queries, 100);
+        start = Clock::now();
+        size_t linearHits = 0;
+        for (size_t q = 0; q < linearQueries; ++q) {
+            for (size_t i = rects.size(); i-- > 0;) {
+                if (rects.getX(i) <= px[q] && px[q] < rects.getX(i) + rects.getWidth(i) &&
+                    rects.getY(i) <= py[q] && py[q] < rects.getY(i) + rects.getHeight(i))
+                {
+                    ++linearHits;
+                    break;
+                }
+            }
+        }
+        double linearTime = secondsSince(start) / static_cast<double>(linearQueries) * static_cast<double>(queries);
+
+        std::vector<size_t> found;
+        size_t regionHits = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < queries; ++i) {
+            found.clear();
+            screen.queryRegion(px[i], py[i], 200.0, 200.0, found);
+            regionHits += found.size();
+        }
+        double regionTime = secondsSince(start);
+
+        start = Clock::now();
+        size_t nearestFound = 0;
+        for (size_t i = 0; i < queries; ++i) {
+            nearestFound += screen.kNearest(px[i], py[i], 10).size();
+        }
+        double nearestTime = secondsSince(start);
+
+        std::cout << "queries on " << rects.size() << " rects, " << queries << " each: hitTest "
+            << hitTime << " s (" << hits << " hits; linear scan ~" << linearTime << " s, "
+            << linearHits << "/" << linearQueries << " hits), queryRegion 200x200 " << regionTime << " s ("
+            << regionHits << " found), kNearest(10) " << nearestTime << " s (" << nearestFound << " found)\n";
+
+        //       (  ,    ):
+        //      -    ,   
+        size_t hitMismatches = 0, regionMismatches = 0, nearestMismatches = 0;
+        std::vector<size_t> expected;
+        std::vector<std::pair<double, size_t>> distances;
+        for (size_t q = 0; q < linearQueries; ++q) {
+            size_t corner = q * rects.size() / linearQueries;
+            const double checkX[] = { px[q], rects.getX(corner), rects.getX(corner) + rects.getWidth(corner) };
+            const double checkY[] = { py[q], rects.getY(corner), rects.getY(corner) + rects.getHeight(corner) };
+            for (size_t p = 0; p < std::size(checkX); ++p) {
+                double x = checkX[p];
+                double y = checkY[p];
+                size_t top = Screen::npos;
+                expected.clear();
+                distances.clear();
+                for (size_t i = 0; i < rects.size(); ++i) {
+                    double x0 = rects.getX(i);
+                    double y0 = rects.getY(i);
+                    double x1 = x0 + rects.getWidth(i);
+                    double y1 = y0 + rects.getHeight(i);
+                    if (x0 <= x && x < x1 && y0 <= y && y < y1) {
+                        top = i;
+                    }
+                    if (x0 < x + 200.0 && x < x1 && y0 < y + 200.0 && y < y1) {
+                        expected.push_back(i);
+                    }
+                    double dx = std::max({ x0 - x, 0.0, x - x1 });
+                    double dy = std::max({ y0 - y, 0.0, y - y1 });
+                    distances.emplace_back(dx * dx + dy * dy, i);
+                }
+                hitMismatches += screen.hitTest(x, y) != top;
+                found.clear();
+                screen.queryRegion(x, y, 200.0, 200.0, found);
+                regionMismatches += found != expected;
+                size_t k = std::min<size_t>(10, distances.size());
+                std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+                std::vector<size_t> nearest = screen.kNearest(x, y, 10);
+                bool same = nearest.size() == k;
+                for (size_t i = 0; same && i < k; ++i) {
+                    same = nearest[i] == distances[i].second;
+                }
+                nearestMismatches += !same;
+            }
+        }
+        if (hitMismatches + regionMismatches + nearestMismatches > 0) {
+            std::cerr << "  MISMATCH: against linear scan hitTest " << hitMismatches << ", queryRegion "
+                << regionMismatches << ", kNearest " << nearestMismatches << " of " << linearQueries * 3 << " points\n";
+        }
+    }
+
+    //       -      
+    void benchEdits(size_t count, size_t edits) {
+        const double screenSize = 20000.0;
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 37);
+        //   notOverlap:      
+        std::vector<Rectangle> plain;
+        plain.reserve(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            const Rectangle& rect = input[i];
+            plain.emplace_back(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(), "", i % 2 == 0);
+        }
+
+        Clock::time_point start = Clock::now();
+        Screen rebuilt(screenSize, screenSize);
+        rebuilt.tryAddRectangles(plain);
+        double rebuildTime = secondsSince(start);
+
+        Screen screen(screenSize, screenSize);
+        screen.tryAddRectangles(plain);
+        //    ,  -   
+        std::vector<size_t> ids(screen.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            ids[i] = i;
+        }
+
+        std::mt19937 rng(41);
+        std::uniform_real_distribution<double> pos(0.0, screenSize - 40.0);
+        std::uniform_real_distribution<double> size(2.0, 40.0);
+        size_t moved = 0, resized = 0, removed = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < edits && !ids.empty(); ++i) {
+            size_t pick = rng() % ids.size();
+            switch (i % 3) {
+            case 0:
+                moved += screen.moveRectangle(ids[pick], pos(rng), pos(rng)).has_value();
+                break;
+            case 1:
+                resized += screen.resizeRectangle(ids[pick], size(rng), size(rng)).has_value();
+                break;
+            default:
+                removed += screen.removeRectangle(ids[pick]);
+                ids[pick] = ids.back();
+                ids.pop_back();
+                break;
+            }
+        }
+        double editTime = secondsSince(start);
+
+        std::cout << "edits on " << count << " rects: rebuild " << rebuildTime << " s per edit; "
+            << edits << " edits " << editTime << " s (" << editTime / static_cast<double>(edits) * 1e6
+            << " us each; " << moved << " moved, " << resized << " resized, " << removed << " removed, "
+            << screen.getRectangles().size() - screen.size() << " slots awaiting compaction)\n";
+
+        // .       =  + ,   
+        //   ids[] -     
+        screen.compact();
+        for (size_t i = 0; i < 1000; ++i) {
+            PlacementResult added = screen.insertRectangle(pos(rng), pos(rng), size(rng), size(rng), Color::None, true);
+            if (added) {
+                ids.push_back(added.value());
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        const RectangleStore& rects = screen.getRectangles();
+        size_t idMismatches = rects.size() != ids.size();
+        for (size_t slot = 0; slot < rects.size() && idMismatches == 0; ++slot) {
+            Rectangle stored = screen.getRectangle(ids[slot]);
+            idMismatches += stored.getX() != rects.getX(slot) || stored.getY() != rects.getY(slot);
+        }
+        //      ;      
+        //   :     notOverlap    
+        Screen replay(screenSize, screenSize);
+        size_t replayRejected = 0;
+        for (const Rectangle& rect : rects) {
+            replayRejected += !replay.tryAddRectangle(rect);
+        }
+        //       findOverlapping   
+        size_t queryMismatches = 0;
+        std::vector<size_t> expected;
+        for (size_t q = 0; q < 100 && idMismatches == 0; ++q) {
+            double x = pos(rng);
+            double y = pos(rng);
+            expected.clear();
+            for (size_t slot = 0; slot < rects.size(); ++slot) {
+                if (rects.getX(slot) < x + 200.0 && x < rects.getX(slot) + rects.getWidth(slot) &&
+                    rects.getY(slot) < y + 200.0 && y < rects.getY(slot) + rects.getHeight(slot))
+                {
+                    expected.push_back(ids[slot]);
+                }
+            }
+            queryMismatches += screen.queryRegion(x, y, 200.0, 200.0) != expected;
+            queryMismatches += screen.findOverlapping(Rectangle(x, y, 200.0, 200.0)) != expected;
+        }
+        if (idMismatches + replayRejected + queryMismatches > 0) {
+            std::cerr << "  MISMATCH: ids " << idMismatches << ", rejected on replay " << replayRejected
+                << ", queries " << queryMismatches << " of 200\n";
+        }
+    }
+
+    // "suite []":        JSON
+    void runSuiteCommand(int argc, char* argv[]) {
+        SuiteOptions options = parseSuiteOptions(argc, argv, 2);
+        std::vector<BenchResult> results = runSuite(options);
+        if (options.jsonFile.empty()) {
+            writeJsonReport(std::cout, options, results);
+            return;
+        }
+        std::ofstream out(options.jsonFile);
+        writeJsonReport(out, options, results);
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Error writing report '" + options.jsonFile + "'");
+        }
+    }
+
+    // "generate  []":      loadFromFile
+    void runGenerateCommand(int argc, char* argv[]) {
+        if (argc < 3) {
+            throw std::invalid_argument("Usage: Lab2YAPBench generate FILE [--count N] [--density D] ...");
+        }
+        SuiteOptions options = parseSuiteOptions(argc, argv, 3);
+        size_t bytes = writeRectangleFile(argv[2], generateRectangles(options.workload));
+        std::cout << "wrote " << options.workload.count << " rects (" << bytes << " bytes, average side "
+            << averageSide(options.workload) << ") to " << argv[2] << "\n";
+    }
+
+    //       :   
+    //  LAB2YAP_NO_STATS   
+    void benchStatsOverhead(size_t count, size_t queries) {
+        const double screenSize = 4000.0;
+        std::vector<Rectangle> input = makeRectangles(count, screenSize, 13);
+        Screen screen(screenSize, screenSize);
+
+        Clock::time_point start = Clock::now();
+        for (const Rectangle& rect : input) {
+            screen.tryEmplaceRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(), Color::None, true);
+        }
+        double insertSeconds = secondsSince(start);
+
+        std::mt19937 rng(14);
+        std::uniform_real_distribution<double> pos(0.0, screenSize);
+        std::vector<double> points(queries * 2);
+        for (double& value : points) {
+            value = pos(rng);
+        }
+        size_t hits = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < queries; ++i) {
+            hits += screen.hitTest(points[2 * i], points[2 * i + 1]) != Screen::npos;
+        }
+        double hitSeconds = secondsSince(start);
+
+#ifdef LAB2YAP_NO_STATS
+        const char* mode = "compiled out";
+#else
+        const char* mode = "collected";
+#endif
+        std::cout << "stats " << mode << ": " << count << " tryEmplaceRectangle " << insertSeconds << " s ("
+            << insertSeconds * 1e9 / static_cast<double>(count) << " ns each), " << queries << " hitTest "
+            << hitSeconds << " s (" << hits << " hits)\n";
+        ScreenStats stats = screen.stats();
+        const LatencyHistogram& inserts = stats.operation(ScreenOp::TryEmplaceRectangle);
+        if (inserts.calls > 0) {
+            std::cout << "  overlap tests " << stats.overlapTests << ", rejected by overlap " << stats.rejectedOverlap
+                << "; tryEmplaceRectangle timed " << inserts.timed << " of " << inserts.calls
+                << ", p50 <= " << inserts.percentileNs(50) << " ns, p99 <= " << inserts.percentileNs(99) << " ns\n";
+        }
+    }
+
+    //      :  
+    //  notOverlap        .
+    //    -  1.2  ,      
+    void benchPlacement(size_t count) {
+        std::mt19937 rng(15);
+        std::uniform_real_distribution<double> side(5.0, 45.0);
+        std::vector<RectangleSize> sizes(count);
+        double totalArea = 0;
+        for (RectangleSize& size : sizes) {
+            size.width = side(rng);
+            size.height = side(rng);
+            totalArea += size.width * size.height;
+        }
+        const double screenSize = std::sqrt(totalArea / 1.2);
+        const int kAttempts = 100;
+
+        auto report = [&](const char* name, double seconds, const Screen& screen, size_t tries) {
+            double covered = 0;
+            const RectangleStore& rects = screen.getRectangles();
+            for (size_t i = 0; i < rects.size(); ++i) {
+                covered += rects.getWidth(i) * rects.getHeight(i);
+            }
+            std::cout << name << " " << seconds << " s (" << screen.size() << " placed, "
+                << static_cast<double>(screen.size()) / seconds << " placed/s, " << tries << " tries, density "
+                << covered / (screenSize * screenSize) << "); ";
+        };
+
+        std::cout << "placement of " << count << " rects on " << screenSize << "x" << screenSize << ": ";
+        {
+            //  :     tryEmplaceRectangle  kAttempts 
+            Screen screen(screenSize, screenSize);
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            size_t tries = 0;
+            Clock::time_point start = Clock::now();
+            for (const RectangleSize& size : sizes) {
+                for (int attempt = 0; attempt < kAttempts; ++attempt) {
+                    ++tries;
+                    if (screen.tryEmplaceRectangle(unit(rng) * (screenSize - size.width),
+                        unit(rng) * (screenSize - size.height), size.width, size.height, Color::None, true))
+                    {
+                        break;
+                    }
+                }
+            }
+            report("random retry", secondsSince(start), screen, tries);
+        }
+        auto place = [&](const char* name, PlacementStrategy strategy) {
+            Screen screen(screenSize, screenSize);
+            Clock::time_point start = Clock::now();
+            for (const RectangleSize& size : sizes) {
+                screen.placeRectangle(size.width, size.height, size.color, strategy);
+            }
+            report(name, secondsSince(start), screen, count);
+        };
+        place("bottom-left", PlacementStrategy::BottomLeft);
+        place("best-fit", PlacementStrategy::BestFit);
+        {
+            Screen screen(screenSize, screenSize);
+            Clock::time_point start = Clock::now();
+            screen.placeRectangles(sizes, PlacementStrategy::BestFit);
+            report("batch best-fit", secondsSince(start), screen, count);
+        }
+        std::cout << "\n";
+    }
+
+    //   SVG  
+    struct SvgEdges {
+        double x0, y0, x1, y1;
+    };
+
+    //  SVG  : <rect>  <path>   
+    struct SvgShape {
+        std::vector<SvgEdges> boxes;
+        std::string fill = "none";
+        bool stroke = false;
+    };
+
+    //   ,   saveSVG  saveSVGOptimized:    ,
+    // <rect x y width height>  <path d="Mx yhWvHh-Wz ...">;  (<rect>  x) 
+    std::vector<SvgShape> readSvgShapes(const char* file) {
+        std::ifstream in(file);
+        std::vector<SvgShape> shapes;
+        std::string line;
+        auto attribute = [&line](const char* name) -> const char* {
+            size_t at = line.find(name);
+            return at == std::string::npos ? nullptr : line.c_str() + at + std::strlen(name);
+        };
+        while (std::getline(in, line)) {
+            SvgShape shape;
+            if (line.find("<rect x=") != std::string::npos) {
+                double x = std::strtod(attribute(" x=\""), nullptr);
+                double y = std::strtod(attribute(" y=\""), nullptr);
+                double w = std::strtod(attribute(" width=\""), nullptr);
+                double h = std::strtod(attribute(" height=\""), nullptr);
+                shape.boxes.push_back({ x, y, x + w, y + h });
+            }
+            else if (const char* path = attribute("<path d=\"")) {
+                const char* pathEnd = std::strchr(path, '"');
+                for (const char* move = std::strchr(path, 'M'); move != nullptr && move < pathEnd; move = std::strchr(move, 'M')) {
+                    char* end = nullptr;
+                    double x = std::strtod(move + 1, &end);
+                    double y = std::strtod(end, &end);
+                    double w = std::strtod(end + 1, &end); //  'h'
+                    double h = std::strtod(end + 1, &end); //  'v'
+                    shape.boxes.push_back({ x, y, x + w, y + h });
+                    move = end;
+                }
+            }
+            else {
+                continue;
+            }
+            if (const char* fill = attribute(" fill=\"")) {
+                shape.fill.assign(fill, std::strchr(fill, '"'));
+            }
+            shape.stroke = line.find(" stroke=") != std::string::npos;
+            shapes.push_back(std::move(shape));
+        }
+        return shapes;
+    }
+
+    //     :   [x0, x1) x [y0, y1),   1 -
+    //       
+    std::string_view svgColorAt(const std::vector<SvgShape>& shapes, double x, double y) {
+        std::string_view color = "background";
+        for (const SvgShape& shape : shapes) {
+            for (const SvgEdges& box : shape.boxes) {
+                if (shape.fill != "none" && box.x0 <= x && x < box.x1 && box.y0 <= y && y < box.y1) {
+                    color = shape.fill;
+                }
+                if (shape.stroke) {
+                    bool outer = box.x0 - 0.5 <= x && x <= box.x1 + 0.5 && box.y0 - 0.5 <= y && y <= box.y1 + 0.5;
+                    bool inner = box.x0 + 0.5 < x && x < box.x1 - 0.5 && box.y0 + 0.5 < y && y < box.y1 - 0.5;
+                    if (outer && !inner) {
+                        color = "stroke";
+                    }
+                }
+            }
+        }
+        return color;
+    }
+
+    //  saveSVG  saveSVGOptimized:  ,     .
+    //  -    ;  -   
+    // (     7-8),   ;  -   ,   
+    void benchOptimizedSVG(size_t count) {
+        const char* file = "bench_optimized.svg";
+        auto fileSize = [file]() {
+            std::ifstream in(file, std::ios::binary | std::ios::ate);
+            return static_cast<std::uint64_t>(in.tellg());
+        };
+        const Color colors[] = { Color::Red, Color::Green, Color::Blue, Color::Yellow };
+        auto run = [&](const char* name, const Screen& screen) {
+            Clock::time_point start = Clock::now();
+            screen.saveSVG(file);
+            double plainTime = secondsSince(start);
+            std::uint64_t plainBytes = fileSize();
+            std::cout << "SVG " << name << ", " << screen.size() << " rects: saveSVG " << plainBytes << " bytes "
+                << plainTime << " s";
+            auto optimized = [&](const char* label, const SvgExportOptions& options) {
+                Clock::time_point optimizedStart = Clock::now();
+                SvgExportSummary summary = screen.saveSVGOptimized(file, options);
+                double seconds = secondsSince(optimizedStart);
+                std::cout << "; " << label << " " << summary.bytes << " bytes (x"
+                    << static_cast<double>(plainBytes) / static_cast<double>(summary.bytes) << ") "
+                    << summary.elements << " elements, " << summary.culled << " culled, " << seconds << " s";
+            };
+            optimized("optimized", SvgExportOptions{});
+            SvgExportOptions quantized;
+            quantized.quantum = 1.0;
+            optimized("quantum 1", quantized);
+            std::cout << "\n";
+        };
+
+        //     :    ,   
+        auto tiles = [&](size_t n) {
+            //  10x10 ;    16x16 
+            size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(n)));
+            Screen screen(side * 10.0, side * 10.0);
+            for (size_t row = 0; row < side; ++row) {
+                for (size_t column = 0; column < side; ++column) {
+                    screen.emplaceRectangle(column * 10.0, row * 10.0, 10.0, 10.0,
+                        colors[(row / 16 + column / 16) % 4]);
+                }
+            }
+            return screen;
+        };
+        // withOutlines:    ,     
+        auto layers = [&](size_t n, bool withOutlines) {
+            const double screenSize = 40.0 * std::sqrt(static_cast<double>(n));
+            std::mt19937 rng(25);
+            std::uniform_real_distribution<double> pos(0.0, screenSize - 200.0);
+            std::uniform_real_distribution<double> size(20.0, 200.0);
+            Screen screen(screenSize, screenSize);
+            for (size_t i = 0; i < n; ++i) {
+                Color color = withOutlines && i % 5 == 0 ? Color::None : colors[rng() % 4];
+                screen.emplaceRectangle(pos(rng), pos(rng), size(rng), size(rng), color);
+            }
+            return screen;
+        };
+        auto sparse = [&](size_t n, double screenSize) {
+            std::vector<Rectangle> input = makeRectangles(n, screenSize, 26);
+            Screen screen(screenSize, screenSize);
+            for (const Rectangle& rect : input) {
+                screen.tryEmplaceRectangle(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(), Color::None, true);
+            }
+            return screen;
+        };
+        run("tiles", tiles(count));
+        run("layers", layers(count, false));
+        run("sparse", sparse(count, 20000.0));
+
+        // :       saveSVG  saveSVGOptimized    
+        // ( quantum  ).  -        
+        //  ;  ,    -     
+        const char* plainFile = "bench_optimized_plain.svg";
+        size_t checkedPoints = 0;
+        size_t mismatches = 0;
+        auto check = [&](const Screen& screen) {
+            screen.saveSVG(plainFile);
+            screen.saveSVGOptimized(file, SvgExportOptions{});
+            std::vector<SvgShape> plain = readSvgShapes(plainFile);
+            std::vector<SvgShape> optimized = readSvgShapes(file);
+            std::mt19937 rng(27);
+            std::uniform_real_distribution<double> across(0.0, screen.getWidth());
+            std::uniform_real_distribution<double> down(0.0, screen.getHeight());
+            std::vector<std::pair<double, double>> points;
+            for (size_t i = 0; i < 4000; ++i) {
+                double x = across(rng);
+                points.emplace_back(x, down(rng));
+            }
+            for (const SvgShape& shape : plain) {
+                for (const SvgEdges& box : shape.boxes) {
+                    double middleX = (box.x0 + box.x1) / 2;
+                    double middleY = (box.y0 + box.y1) / 2;
+                    for (double offset : { -0.6, -0.5, -0.4, -1e-9, 0.0, 0.4, 0.5, 0.6 }) {
+                        points.emplace_back(box.x0 + offset, middleY);
+                        points.emplace_back(box.x1 + offset, middleY);
+                        points.emplace_back(middleX, box.y0 + offset);
+                        points.emplace_back(middleX, box.y1 + offset);
+                        points.emplace_back(box.x0 + offset, box.y0 + offset);
+                        points.emplace_back(box.x1 + offset, box.y1 + offset);
+                    }
+                }
+            }
+            for (const std::pair<double, double>& point : points) {
+                mismatches += svgColorAt(plain, point.first, point.second) != svgColorAt(optimized, point.first, point.second);
+            }
+            checkedPoints += points.size();
+        };
+        const size_t checkCount = std::min<size_t>(count, 1000);
+        check(tiles(checkCount));
+        check(layers(checkCount, false));
+        check(layers(checkCount, true));
+        check(sparse(checkCount, 2000.0));
+        if (mismatches > 0) {
+            std::cerr << "  MISMATCH: saveSVGOptimized against saveSVG differs at " << mismatches << " of "
+                << checkedPoints << " points\n";
+        }
+        std::remove(plainFile);
+        std::remove(file);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string_view command = argc > 1 ? argv[1] : "";
+    try {
+        if (command == "suite") {
+            runSuiteCommand(argc, argv);
+            return 0;
+        }
+        if (command == "generate") {
+            runGenerateCommand(argc, argv);
+            return 0;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    //   -   ;  -   .
+    //    count * 50 ,       
+    size_t count = 20000;
+    if (argc > 1) {
+        try {
+            count = parseInteger<size_t>(argv[1]);
+            if (count == 0 || count > std::numeric_limits<size_t>::max() / 50) {
+                throw std::invalid_argument("Rectangle count out of range: " + std::string(argv[1]));
+            }
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << "\n"
+                << "Usage: Lab2YAPBench [COUNT] | suite [--count N ...] | generate FILE [--count N ...]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        benchOverlapIndex(count / 10);
+        benchOverlapIndex(count);
+        benchBatchInsert(count * 10);
+        benchDenseOverlap(count, 2000);
+        benchSceneReload(count * 10);
+        benchLoadClearCycles(count * 5, 10);
+        benchInsertPath(count * 10);
+        benchIncrementalSVG(count * 10, 10);
+        benchAsyncSVG(count * 10);
+        benchConcurrentInsert(count * 10);
+        benchRasterize(count * 50);
+        benchQueries(count * 50, 100000);
+        //    :   ,  ,    
+        benchEdits(count * 50, std::min<size_t>(300000, count * 50));
+        benchStatsOverhead(count * 50, 1000000);
+        benchPlacement(count / 2);
+        benchOptimizedSVG(count * 5);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
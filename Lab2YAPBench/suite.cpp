@@ -0,0 +1,318 @@
+#include "suite.h"
+#include "screen.h"
+#include "file_parser.h"
+#include <algorithm> //  std::sort, std::min
+#include <charconv>  //  std::to_chars, std::from_chars
+#include <chrono>
+#include <cmath>     //  std::ceil, std::isfinite
+#include <fstream>
+#include <iterator>  //  std::size
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    std::uint64_t nanosecondsSince(Clock::time_point start) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    //   op(i)  ; op ,   
+    template <typename Op>
+    void timeEach(BenchResult& result, size_t count, Op op) {
+        result.latency.reserve(count);
+        std::uint64_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            Clock::time_point start = Clock::now();
+            bool accepted = op(i);
+            std::uint64_t elapsed = nanosecondsSince(start);
+            result.latency.add(elapsed);
+            total += elapsed;
+            ++(accepted ? result.accepted : result.rejected);
+        }
+        result.operations += count;
+        result.items += count;
+        result.seconds += static_cast<double>(total) * 1e-9;
+    }
+
+    std::vector<Rectangle> withFlag(const std::vector<Rectangle>& rects, bool notOverlap) {
+        std::vector<Rectangle> result;
+        result.reserve(rects.size());
+        for (const Rectangle& rect : rects) {
+            result.emplace_back(rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight(),
+                rect.getColorId(), notOverlap);
+        }
+        return result;
+    }
+
+    BenchResult benchAdd(const SuiteOptions& options, const std::vector<Rectangle>& rects, bool notOverlap) {
+        BenchResult result;
+        result.name = "addRectangle";
+        result.notOverlap = notOverlap;
+        Screen screen(options.workload.screenWidth, options.workload.screenHeight);
+        timeEach(result, rects.size(), [&](size_t i) {
+            try {
+                screen.addRectangle(rects[i]);
+                return true;
+            }
+            catch (const ScreenError&) {
+                return false;
+            }
+        });
+        return result;
+    }
+
+    BenchResult benchTryAdd(const SuiteOptions& options, const std::vector<Rectangle>& rects, bool notOverlap) {
+        BenchResult result;
+        result.name = "tryAddRectangle";
+        result.notOverlap = notOverlap;
+        Screen screen(options.workload.screenWidth, options.workload.screenHeight);
+        timeEach(result, rects.size(), [&](size_t i) { return screen.tryAddRectangle(rects[i]); });
+        return result;
+    }
+
+    BenchResult benchLoad(const SuiteOptions& options, LoadMode mode, const char* name, size_t fileBytes) {
+        BenchResult result;
+        result.name = name;
+        result.notOverlap = options.workload.notOverlapShare > 0;
+        for (int run = 0; run < options.runs; ++run) {
+            Screen screen(options.workload.screenWidth, options.workload.screenHeight);
+            Clock::time_point start = Clock::now();
+            bool loaded = true;
+            try {
+                screen.loadFromFile(options.workloadFile, mode);
+            }
+            catch (const FileParseError&) {
+                loaded = false; //    notOverlap:   
+            }
+            std::uint64_t elapsed = nanosecondsSince(start);
+            result.latency.add(elapsed);
+            result.seconds += static_cast<double>(elapsed) * 1e-9;
+            ++result.operations;
+            ++(loaded ? result.accepted : result.rejected);
+            result.items += screen.size();
+            result.bytes += fileBytes;
+        }
+        return result;
+    }
+
+    //       :   
+    BenchResult benchStream(const SuiteOptions& options, size_t fileBytes) {
+        BenchResult result;
+        result.name = "streamRectangles";
+        result.notOverlap = options.workload.notOverlapShare > 0;
+        for (int run = 0; run < options.runs; ++run) {
+            std::ifstream in(options.workloadFile, std::ios::in | std::ios::binary);
+            size_t batches = 0;
+            Clock::time_point start = Clock::now();
+            size_t count = streamRectangles(in, options.workloadFile,
+                [&](const RectangleStore&, int) { ++batches; });
+            std::uint64_t elapsed = nanosecondsSince(start);
+            result.latency.add(elapsed);
+            result.seconds += static_cast<double>(elapsed) * 1e-9;
+            ++result.operations;
+            ++result.accepted;
+            result.items += count;
+            result.bytes += fileBytes;
+        }
+        return result;
+    }
+
+    BenchResult benchSaveSVG(const SuiteOptions& options, const std::vector<Rectangle>& rects) {
+        BenchResult result;
+        result.name = "saveSVG";
+        Screen screen(options.workload.screenWidth, options.workload.screenHeight);
+        screen.addRectangles(rects);
+        for (int run = 0; run < options.runs; ++run) {
+            Clock::time_point start = Clock::now();
+            screen.saveSVG(options.svgFile);
+            std::uint64_t elapsed = nanosecondsSince(start);
+            result.latency.add(elapsed);
+            result.seconds += static_cast<double>(elapsed) * 1e-9;
+            ++result.operations;
+            ++result.accepted;
+            result.items += screen.size();
+        }
+        std::ifstream written(options.svgFile, std::ios::binary | std::ios::ate);
+        result.bytes = static_cast<size_t>(written.tellg()) * static_cast<size_t>(options.runs);
+        return result;
+    }
+
+    // --- JSON ---
+    void writeNumber(std::ostream& out, double value) {
+        if (!std::isfinite(value)) {
+            out << "null";
+            return;
+        }
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.write(buffer, result.ptr - buffer);
+    }
+
+    //     -  ASCII-    '\'
+    void writeField(std::ostream& out, const char* name, std::string_view value, bool last = false) {
+        out << '"' << name << "\": \"" << value << '"' << (last ? "" : ", ");
+    }
+
+    void writeField(std::ostream& out, const char* name, double value, bool last = false) {
+        out << '"' << name << "\": ";
+        writeNumber(out, value);
+        out << (last ? "" : ", ");
+    }
+
+    void writeField(std::ostream& out, const char* name, size_t value, bool last = false) {
+        out << '"' << name << "\": " << value << (last ? "" : ", ");
+    }
+
+    double perSecond(double amount, double seconds) {
+        return seconds > 0 ? amount / seconds : 0.0;
+    }
+
+    double parseDouble(const char* text) {
+        std::string_view view(text);
+        double value = 0;
+        std::from_chars_result result = std::from_chars(view.data(), view.data() + view.size(), value);
+        if (result.ec != std::errc() || result.ptr != view.data() + view.size() || !std::isfinite(value)) {
+            throw std::invalid_argument("Invalid number: " + std::string(view));
+        }
+        return value;
+    }
+}
+
+std::uint64_t LatencySamples::percentile(double p) {
+    if (m_samples.empty()) {
+        return 0;
+    }
+    if (!m_sorted) {
+        std::sort(m_samples.begin(), m_samples.end());
+        m_sorted = true;
+    }
+    double rank = std::ceil(p / 100.0 * static_cast<double>(m_samples.size()));
+    size_t index = rank < 1 ? 0 : std::min(m_samples.size(), static_cast<size_t>(rank)) - 1;
+    return m_samples[index];
+}
+
+std::vector<BenchResult> runSuite(const SuiteOptions& options) {
+    std::vector<Rectangle> rects = generateRectangles(options.workload);
+    size_t fileBytes = writeRectangleFile(options.workloadFile, rects);
+    std::vector<Rectangle> plain = withFlag(rects, false);
+    std::vector<Rectangle> flagged = withFlag(rects, true);
+
+    std::vector<BenchResult> results;
+    results.push_back(benchAdd(options, plain, false));
+    results.push_back(benchAdd(options, flagged, true));
+    results.push_back(benchTryAdd(options, plain, false));
+    results.push_back(benchTryAdd(options, flagged, true));
+    results.push_back(benchLoad(options, LoadMode::Buffered, "loadFromFile/buffered", fileBytes));
+    results.push_back(benchLoad(options, LoadMode::Mapped, "loadFromFile/mapped", fileBytes));
+    results.push_back(benchLoad(options, LoadMode::Parallel, "loadFromFile/parallel", fileBytes));
+    results.push_back(benchStream(options, fileBytes));
+    results.push_back(benchSaveSVG(options, plain));
+    return results;
+}
+
+void writeJsonReport(std::ostream& out, const SuiteOptions& options, std::vector<BenchResult>& results) {
+    const WorkloadConfig& workload = options.workload;
+    out << "{\n  \"config\": {";
+    writeField(out, "count", workload.count);
+    writeField(out, "screenWidth", workload.screenWidth);
+    writeField(out, "screenHeight", workload.screenHeight);
+    writeField(out, "density", workload.density);
+    writeField(out, "sizeSpread", workload.sizeSpread);
+    writeField(out, "averageSide", averageSide(workload));
+    writeField(out, "notOverlapShare", workload.notOverlapShare);
+    writeField(out, "seed", static_cast<size_t>(workload.seed));
+    writeField(out, "runs", static_cast<size_t>(options.runs));
+    out << "\"colorWeights\": {";
+    for (size_t i = 0; i < kColorCount; ++i) {
+        std::string_view name = Rectangle::colorName(static_cast<Color>(i));
+        out << '"' << (name.empty() ? std::string_view("none") : name) << "\": ";
+        writeNumber(out, workload.colorWeights[i]);
+        out << (i + 1 < kColorCount ? ", " : "");
+    }
+    out << "}},\n  \"results\": [\n";
+
+    const double percentiles[] = { 50, 90, 99, 99.9 };
+    const char* percentileNames[] = { "p50", "p90", "p99", "p999" };
+    for (size_t i = 0; i < results.size(); ++i) {
+        BenchResult& result = results[i];
+        out << "    {";
+        writeField(out, "name", result.name);
+        out << "\"notOverlap\": " << (result.notOverlap ? "true" : "false") << ", ";
+        writeField(out, "operations", result.operations);
+        writeField(out, "items", result.items);
+        writeField(out, "accepted", result.accepted);
+        writeField(out, "rejected", result.rejected);
+        writeField(out, "bytes", result.bytes);
+        writeField(out, "seconds", result.seconds);
+        writeField(out, "operationsPerSecond", perSecond(static_cast<double>(result.operations), result.seconds));
+        writeField(out, "itemsPerSecond", perSecond(static_cast<double>(result.items), result.seconds));
+        writeField(out, "bytesPerSecond", perSecond(static_cast<double>(result.bytes), result.seconds));
+        out << "\"latencyNs\": {";
+        writeField(out, "min", static_cast<size_t>(result.latency.percentile(0)));
+        for (size_t p = 0; p < std::size(percentiles); ++p) {
+            writeField(out, percentileNames[p], static_cast<size_t>(result.latency.percentile(percentiles[p])));
+        }
+        writeField(out, "max", static_cast<size_t>(result.latency.percentile(100)), true);
+        out << "}}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+SuiteOptions parseSuiteOptions(int argc, char* argv[], int first) {
+    SuiteOptions options;
+    WorkloadConfig& workload = options.workload;
+    for (int i = first; i < argc; ++i) {
+        std::string_view name = argv[i];
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for option " + std::string(name));
+        }
+        const char* value = argv[++i];
+        if (name == "--count") {
+            workload.count = parseInteger<size_t>(value);
+        }
+        else if (name == "--width") {
+            workload.screenWidth = parseDouble(value);
+        }
+        else if (name == "--height") {
+            workload.screenHeight = parseDouble(value);
+        }
+        else if (name == "--density") {
+            workload.density = parseDouble(value);
+        }
+        else if (name == "--spread") {
+            workload.sizeSpread = parseDouble(value);
+        }
+        else if (name == "--not-overlap") {
+            workload.notOverlapShare = parseDouble(value);
+        }
+        else if (name == "--colors") {
+            workload.colorWeights = parseColorWeights(value);
+        }
+        else if (name == "--seed") {
+            workload.seed = parseInteger<unsigned>(value);
+        }
+        else if (name == "--runs") {
+            options.runs = parseInteger<int>(value);
+        }
+        else if (name == "--file") {
+            options.workloadFile = value;
+        }
+        else if (name == "--svg") {
+            options.svgFile = value;
+        }
+        else if (name == "--json") {
+            options.jsonFile = value;
+        }
+        else {
+            throw std::invalid_argument("Unknown option " + std::string(name));
+        }
+    }
+    if (!(workload.screenWidth > 0 && workload.screenHeight > 0 && workload.density > 0 &&
+        workload.sizeSpread >= 0 && workload.notOverlapShare >= 0 && options.runs > 0))
+    {
+        throw std::invalid_argument("Sizes, density and runs must be positive; spread and share non-negative.");
+    }
+    return options;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "workload.h"
+#include <charconv>  //  std::from_chars
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//         
+class LatencySamples {
+public:
+    void reserve(size_t count) { m_samples.reserve(count); }
+    void add(std::uint64_t nanoseconds) {
+        m_samples.push_back(nanoseconds);
+        m_sorted = false;
+    }
+    size_t size() const noexcept { return m_samples.size(); }
+
+    //  : p      (p  0  100); 0,   .
+    //     
+    std::uint64_t percentile(double p);
+
+private:
+    std::vector<std::uint64_t> m_samples;
+    bool m_sorted = false;
+};
+
+//   
+struct BenchResult {
+    std::string name;
+    bool notOverlap = false;
+    size_t operations = 0; //  
+    size_t items = 0;      // ,   
+    size_t accepted = 0;
+    size_t rejected = 0;   //  (  false)
+    size_t bytes = 0;      //    (, SVG)
+    double seconds = 0;    //   
+    LatencySamples latency;
+};
+
+struct SuiteOptions {
+    WorkloadConfig workload;
+    int runs = 5; //   loadFromFile  saveSVG:   -   
+    std::string workloadFile = "bench_workload.txt";
+    std::string svgFile = "bench_suite.svg";
+    std::string jsonFile; //  -   stdout
+};
+
+//  : addRectangle  tryAddRectangle  notOverlap   , loadFromFile  
+// ,  streamRectangles, saveSVG.     options.workloadFile
+std::vector<BenchResult> runSuite(const SuiteOptions& options);
+
+//   JSON:           
+void writeJsonReport(std::ostream& out, const SuiteOptions& options, std::vector<BenchResult>& results);
+
+// "--count 100000 --density 0.8 ..."   argv[first]; std::invalid_argument  
+SuiteOptions parseSuiteOptions(int argc, char* argv[], int first);
+
+//      ;      from_chars  .
+// std::invalid_argument,           Integer
+template <typename Integer>
+Integer parseInteger(const char* text) {
+    std::string_view view(text);
+    Integer value = 0;
+    std::from_chars_result result = std::from_chars(view.data(), view.data() + view.size(), value);
+    if (result.ec == std::errc::result_out_of_range) {
+        throw std::invalid_argument("Integer out of range: " + std::string(view));
+    }
+    if (result.ec != std::errc() || result.ptr != view.data() + view.size()) {
+        throw std::invalid_argument("Invalid integer: " + std::string(view));
+    }
+    return value;
+}
@@ -0,0 +1,118 @@
+#include "workload.h"
+#include <algorithm> //  std::min, std::max, std::clamp, std::all_of
+#include <charconv>  //  std::to_chars, std::from_chars
+#include <cmath>     //  std::sqrt, std::floor, std::isfinite
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    //     1/64:         ,
+    //          
+    const double kQuantum = 1.0 / 64.0;
+    const double kMaxSide = 1000.0; //  Rectangle::validateDimensions
+
+    double quantize(double value) {
+        return std::floor(value / kQuantum) * kQuantum;
+    }
+
+    void appendNumber(std::string& out, double value) {
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+}
+
+double averageSide(const WorkloadConfig& config) {
+    if (config.count == 0) {
+        return 0.0;
+    }
+    double side = std::sqrt(config.density * config.screenWidth * config.screenHeight /
+        static_cast<double>(config.count));
+    return std::min(side, kMaxSide);
+}
+
+std::vector<Rectangle> generateRectangles(const WorkloadConfig& config) {
+    double side = averageSide(config);
+    double spread = std::clamp(config.sizeSpread, 0.0, 1.0);
+    double maxSide = std::min({ kMaxSide, config.screenWidth, config.screenHeight });
+    double lo = std::max(kQuantum, side * (1.0 - spread));
+    double hi = std::max(lo, std::min(maxSide, side * (1.0 + spread)));
+
+    std::mt19937 rng(config.seed);
+    std::uniform_real_distribution<double> sideDist(lo, hi);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::discrete_distribution<int> colorDist(config.colorWeights.begin(), config.colorWeights.end());
+
+    std::vector<Rectangle> result;
+    result.reserve(config.count);
+    for (size_t i = 0; i < config.count; ++i) {
+        double w = std::max(kQuantum, quantize(sideDist(rng)));
+        double h = std::max(kQuantum, quantize(sideDist(rng)));
+        double x = quantize(unit(rng) * (config.screenWidth - w));
+        double y = quantize(unit(rng) * (config.screenHeight - h));
+        Color color = static_cast<Color>(colorDist(rng));
+        bool notOverlap = unit(rng) < config.notOverlapShare;
+        result.emplace_back(x, y, w, h, color, notOverlap);
+    }
+    return result;
+}
+
+size_t writeRectangleFile(const std::string& filename, const std::vector<Rectangle>& rects) {
+    std::string text;
+    text.reserve(rects.size() * 40);
+    for (const Rectangle& rect : rects) {
+        appendNumber(text, rect.getX() + rect.getWidth() / 2.0);
+        text += ' ';
+        appendNumber(text, rect.getY() + rect.getHeight() / 2.0);
+        text += ' ';
+        appendNumber(text, rect.getWidth());
+        text += ' ';
+        appendNumber(text, rect.getHeight());
+        if (rect.getColorId() != Color::None) {
+            text += ' ';
+            text += rect.getColor();
+        }
+        if (rect.getNotOverlap()) {
+            text += " 1";
+        }
+        text += '\n';
+    }
+
+    std::ofstream out(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Error writing workload file '" + filename + "'");
+    }
+    return text.size();
+}
+
+std::array<double, kColorCount> parseColorWeights(std::string_view spec) {
+    std::array<double, kColorCount> weights = {};
+    while (!spec.empty()) {
+        size_t comma = spec.find(',');
+        std::string_view item = spec.substr(0, comma);
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+
+        size_t equals = item.find('=');
+        if (equals == std::string_view::npos) {
+            throw std::invalid_argument("Color weight must look like 'name=weight': " + std::string(item));
+        }
+        std::string_view name = item.substr(0, equals);
+        std::string_view value = item.substr(equals + 1);
+        Color color = name == "none" ? Color::None : Rectangle::colorFromName(name);
+        double weight = 0.0;
+        std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), weight);
+        if (result.ec != std::errc() || result.ptr != value.data() + value.size() ||
+            !std::isfinite(weight) || weight < 0)
+        {
+            throw std::invalid_argument("Invalid color weight: " + std::string(item));
+        }
+        weights[static_cast<size_t>(color)] = weight;
+    }
+    if (std::all_of(weights.begin(), weights.end(), [](double weight) { return weight == 0; })) {
+        throw std::invalid_argument("At least one color weight must be positive.");
+    }
+    return weights;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "rectangle.h"
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//    :     ,
+//     .     seed      .
+struct WorkloadConfig {
+    size_t count = 100000;
+    double screenWidth = 10000.0;
+    double screenHeight = 10000.0;
+    //       (1 -    
+    //   ).     
+    double density = 0.5;
+    //    [s * (1 - spread), s * (1 + spread)], s -  
+    double sizeSpread = 0.5;
+    double notOverlapShare = 0.0; //    notOverlap
+    //    ( -  Color);      
+    std::array<double, kColorCount> colorWeights = { 0, 1, 1, 1, 1, 1, 1, 1, 1 };
+    unsigned seed = 1;
+};
+
+//         (   1000)
+double averageSide(const WorkloadConfig& config);
+
+//   ;     
+std::vector<Rectangle> generateRectangles(const WorkloadConfig& config);
+
+//    Screen::loadFromFile: "cx cy w h color [1]",  - .
+//  None      ,      
+//     .   - std::runtime_error.
+//     .
+size_t writeRectangleFile(const std::string& filename, const std::vector<Rectangle>& rects);
+
+//      "red=3,blue=1,none=0.5";      0.
+//      - std::invalid_argument
+std::array<double, kColorCount> parseColorWeights(std::string_view spec);